@@ -0,0 +1,106 @@
+#include "../include/prng30.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+//  Per-block cost of the counter-based API against width. Setup (seeding
+//  plus the width/2 warmup) is paid once per block, so it sets the smallest
+//  block size worth using at each width.
+
+//  Usage:
+//    ./block_bench [block_bytes]
+
+//    block_bytes : bytes generated per block in the second column (def: 64)
+
+//  Columns:
+//    setup      : prng30_block with len = 0, i.e. pure per-block overhead
+//    block      : prng30_block with len = block_bytes
+//    init+free  : prng30_init + prng30_free, the allocating equivalent
+//    stream     : cost of block_bytes from an already-running generator
+//    breakeven  : bytes per block at which setup equals generation cost
+
+//  Example:
+//    ./block_bench 4096
+
+#define MIN_SECONDS 0.2
+
+static volatile uint8_t g_sink;
+
+static double now(void) {
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// Nanoseconds per call, repeating until MIN_SECONDS has elapsed.
+static double time_block(int width, size_t len, uint8_t *buf) {
+    uint64_t calls = 0;
+    double   t0    = now(), t;
+    do {
+        for (int i = 0; i < 64; i++)
+            prng30_block(0xB10C, width, calls++, buf, len);
+        t = now() - t0;
+    } while (t < MIN_SECONDS);
+    g_sink = buf[0];
+    return t * 1e9 / (double)calls;
+}
+
+static double time_init(int width) {
+    uint64_t     calls = 0;
+    double       t0    = now(), t;
+    prng30_state st;
+    do {
+        for (int i = 0; i < 64; i++) {
+            prng30_init(&st, calls++, width);
+            prng30_free(&st);
+        }
+        t = now() - t0;
+    } while (t < MIN_SECONDS);
+    return t * 1e9 / (double)calls;
+}
+
+static double time_stream(int width, size_t len, uint8_t *buf) {
+    uint64_t     calls = 0;
+    double       t0    = now(), t;
+    prng30_state st;
+    prng30_init(&st, 1, width);
+    do {
+        for (int i = 0; i < 64; i++, calls++)
+            prng30_fill(&st, buf, len);
+        t = now() - t0;
+    } while (t < MIN_SECONDS);
+    prng30_free(&st);
+    g_sink = buf[0];
+    return t * 1e9 / (double)calls;
+}
+
+int main(int argc, char *argv[]) {
+    size_t len = 64;
+    if (argc >= 2)
+        len = (size_t)strtoull(argv[1], NULL, 10);
+    if (len == 0)
+        len = 1;
+
+    uint8_t *buf = malloc(len);
+    if (!buf) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    static const int widths[] = {32, 64, 128, 256, 512, 1024, 2048, 4096};
+
+    printf("prng30_block cost per call  (block_bytes=%zu)\n\n", len);
+    printf("%6s  %12s  %12s  %12s  %12s  %12s\n", "width", "setup ns", "block ns", "init+free ns", "stream ns", "breakeven B");
+
+    for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++) {
+        int    w      = widths[i];
+        double setup  = time_block(w, 0, buf);
+        double block  = time_block(w, len, buf);
+        double init   = time_init(w);
+        double stream = time_stream(w, len, buf);
+        printf("%6d  %12.0f  %12.0f  %12.0f  %12.0f  %12.0f\n", w, setup, block, init, stream, setup / (stream / (double)len));
+    }
+
+    free(buf);
+    return 0;
+}
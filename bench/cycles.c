@@ -0,0 +1,414 @@
+#include "../include/prng30.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+//  Empirical period measurement. Runs Brent's cycle detection on the
+//  bit-packed automaton for many seeds per width, in parallel, and reports
+//  the distribution of transient (tail) and cycle lengths per width.
+//  The start point of each orbit is the state right after prng30_init.
+
+//  Usage:
+//    ./cycles [widths] [seeds] [threads] [checkpoint] [max_steps]
+
+//    widths     : one width or a range lo-hi (def: 32-40)
+//    seeds      : seeds per width (def: 16)
+//    threads    : worker threads (def: online CPUs)
+//    checkpoint : progress file, resumed from if present (def: cycles.ckpt)
+//    max_steps  : give up on an orbit after this many steps (def: 2^40)
+
+//  Long runs can be interrupted at any time; rerunning the same command
+//  continues from the last checkpoint (written every 10 s).
+
+//  Example:
+//    ./cycles 32-48 64 8
+//    ./cycles 56 8 8 w56.ckpt 1000000000000
+
+#define SLICE_STEPS (1u << 22)
+#define CKPT_PERIOD 10
+
+enum { PH_LAMBDA, PH_LEAD, PH_MU, PH_DONE };
+
+typedef struct {
+    int      width;
+    uint64_t seed;
+    int      phase;
+    uint64_t power, lam, mu, lead, steps;
+    int      failed; // prng30_init failed; not checkpointed, so a rerun retries
+    // Tortoise and hare rows, PRNG30_WORDS(width) words each. Counters and
+    // rows are published together under g_lock at the end of each slice.
+    uint64_t *tortoise;
+    uint64_t *hare;
+} job;
+
+static job            *g_jobs;
+static int             g_njobs;
+static int             g_next;
+static int             g_running;
+static uint64_t        g_max_steps = 1ULL << 40;
+static pthread_mutex_t g_lock      = PTHREAD_MUTEX_INITIALIZER;
+
+static int finished(const job *j) {
+    return j->failed || j->phase == PH_DONE || j->steps >= g_max_steps;
+}
+
+static size_t row_bytes(int width) {
+    return (size_t)PRNG30_WORDS(width) * sizeof(uint64_t);
+}
+
+static int rows_equal(const prng30_state *a, const prng30_state *b) {
+    return memcmp(a->row, b->row, (size_t)a->nwords * sizeof(uint64_t)) == 0;
+}
+
+// Run at most SLICE_STEPS steps of the job's current phase on the two
+// working states, advancing the job's counters.
+static void run_slice(job *j, prng30_state *t, prng30_state *h) {
+    uint32_t budget = SLICE_STEPS;
+
+    while (budget && !finished(j)) {
+        switch (j->phase) {
+        case PH_LAMBDA:
+            // Brent: the tortoise teleports to the hare at powers of two.
+            if (j->power == j->lam) {
+                memcpy(t->row, h->row, row_bytes(j->width));
+                j->power <<= 1;
+                j->lam = 0;
+            }
+            prng30_step(h);
+            j->lam++;
+            if (rows_equal(t, h)) {
+                // Cycle length found; restart both from x0 with the hare
+                // lam steps ahead to locate the start of the cycle.
+                prng30_free(t);
+                prng30_free(h);
+                if (prng30_init(t, j->seed, j->width) != PRNG30_OK || prng30_init(h, j->seed, j->width) != PRNG30_OK) {
+                    j->failed = 1;
+                    return;
+                }
+                j->phase = PH_LEAD;
+                j->lead  = 0;
+            }
+            break;
+        case PH_LEAD:
+            if (j->lead == j->lam) {
+                j->phase = PH_MU;
+                j->mu    = 0;
+                if (rows_equal(t, h))
+                    j->phase = PH_DONE;
+                break;
+            }
+            prng30_step(h);
+            j->lead++;
+            break;
+        case PH_MU:
+            prng30_step(t);
+            prng30_step(h);
+            j->mu++;
+            if (rows_equal(t, h))
+                j->phase = PH_DONE;
+            break;
+        }
+
+        j->steps++;
+        budget--;
+    }
+}
+
+static void *worker(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        pthread_mutex_lock(&g_lock);
+        int idx = g_next;
+        while (idx < g_njobs && finished(&g_jobs[idx]))
+            idx++;
+        g_next = idx + 1;
+        pthread_mutex_unlock(&g_lock);
+
+        if (idx >= g_njobs)
+            break;
+
+        job         *j = &g_jobs[idx];
+        job          cur;
+        prng30_state t, h;
+        int          ok = prng30_init(&t, j->seed, j->width) == PRNG30_OK;
+        ok              = prng30_init(&h, j->seed, j->width) == PRNG30_OK && ok;
+
+        pthread_mutex_lock(&g_lock);
+        if (!ok)
+            j->failed = 1;
+        else if (j->steps == 0) {
+            j->power = j->lam = 1;
+            prng30_step(&h);
+            j->steps = 1;
+            if (rows_equal(&t, &h)) {
+                j->phase = PH_LEAD;
+                prng30_free(&h);
+                if (prng30_init(&h, j->seed, j->width) != PRNG30_OK)
+                    j->failed = 1;
+            }
+        } else {
+            memcpy(t.row, j->tortoise, row_bytes(j->width));
+            memcpy(h.row, j->hare, row_bytes(j->width));
+        }
+        cur = *j;
+        pthread_mutex_unlock(&g_lock);
+
+        while (!finished(&cur)) {
+            run_slice(&cur, &t, &h);
+            pthread_mutex_lock(&g_lock);
+            *j = cur;
+            memcpy(j->tortoise, t.row, row_bytes(j->width));
+            memcpy(j->hare, h.row, row_bytes(j->width));
+            pthread_mutex_unlock(&g_lock);
+        }
+
+        if (j->failed)
+            fprintf(stderr, "width=%d seed=%016llx  prng30_init failed\n", j->width, (unsigned long long)j->seed);
+        else if (j->phase == PH_DONE)
+            fprintf(stderr, "width=%d seed=%016llx  transient=%llu  cycle=%llu\n", j->width, (unsigned long long)j->seed,
+                    (unsigned long long)j->mu, (unsigned long long)j->lam);
+        else
+            fprintf(stderr, "width=%d seed=%016llx  gave up after %llu steps\n", j->width, (unsigned long long)j->seed,
+                    (unsigned long long)j->steps);
+
+        prng30_free(&t);
+        prng30_free(&h);
+    }
+
+    pthread_mutex_lock(&g_lock);
+    g_running--;
+    pthread_mutex_unlock(&g_lock);
+    return NULL;
+}
+
+// Checkpoint format, one line per job:
+//   <width> <seed> <phase> <power> <lam> <mu> <lead> <steps> <tortoise words> <hare words>
+static void save_checkpoint(const char *path) {
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    FILE *f = fopen(tmp, "w");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", tmp);
+        return;
+    }
+
+    pthread_mutex_lock(&g_lock);
+    fprintf(f, "prng30-cycles 1 %d\n", g_njobs);
+    for (int i = 0; i < g_njobs; i++) {
+        const job *j = &g_jobs[i];
+        fprintf(f, "%d %llu %d %llu %llu %llu %llu %llu", j->width, (unsigned long long)j->seed, j->phase,
+                (unsigned long long)j->power, (unsigned long long)j->lam, (unsigned long long)j->mu, (unsigned long long)j->lead,
+                (unsigned long long)j->steps);
+        for (int w = 0; w < PRNG30_WORDS(j->width); w++)
+            fprintf(f, " %llx", (unsigned long long)j->tortoise[w]);
+        for (int w = 0; w < PRNG30_WORDS(j->width); w++)
+            fprintf(f, " %llx", (unsigned long long)j->hare[w]);
+        fprintf(f, "\n");
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    if (fclose(f) == 0)
+        rename(tmp, path);
+}
+
+static void load_checkpoint(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return;
+
+    int n = 0, restored = 0;
+    if (fscanf(f, "prng30-cycles 1 %d", &n) != 1) {
+        fprintf(stderr, "ignoring unrecognised checkpoint %s\n", path);
+        fclose(f);
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        int                width, phase;
+        unsigned long long seed, power, lam, mu, lead, steps;
+        if (fscanf(f, "%d %llu %d %llu %llu %llu %llu %llu", &width, &seed, &phase, &power, &lam, &mu, &lead, &steps) != 8)
+            break;
+
+        job *j = NULL;
+        for (int k = 0; k < g_njobs; k++)
+            if (g_jobs[k].width == width && g_jobs[k].seed == seed)
+                j = &g_jobs[k];
+
+        uint64_t words[2 * PRNG30_WORDS(PRNG30_MAX_WIDTH)];
+        int      nw = PRNG30_WORDS(width);
+        if (nw > PRNG30_WORDS(PRNG30_MAX_WIDTH))
+            break;
+        for (int w = 0; w < 2 * nw; w++) {
+            unsigned long long v;
+            if (fscanf(f, "%llx", &v) != 1)
+                goto done;
+            words[w] = v;
+        }
+
+        if (!j)
+            continue;
+        j->phase = phase;
+        j->power = power;
+        j->lam   = lam;
+        j->mu    = mu;
+        j->lead  = lead;
+        j->steps = steps;
+        memcpy(j->tortoise, words, row_bytes(width));
+        memcpy(j->hare, words + nw, row_bytes(width));
+        restored++;
+    }
+
+done:
+    fclose(f);
+    fprintf(stderr, "resumed %d job(s) from %s\n", restored, path);
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Returns the number of orbits that failed to start.
+static int report_width(int width, int nseeds, const job *jobs) {
+    uint64_t *mu  = malloc((size_t)nseeds * sizeof(uint64_t));
+    uint64_t *lam = malloc((size_t)nseeds * sizeof(uint64_t));
+    int       n = 0, failed = 0;
+
+    for (int i = 0; i < nseeds; i++)
+        failed += jobs[i].failed;
+    if (!mu || !lam) {
+        free(mu);
+        free(lam);
+        return failed;
+    }
+
+    for (int i = 0; i < nseeds; i++)
+        if (!jobs[i].failed && jobs[i].phase == PH_DONE) {
+            mu[n]  = jobs[i].mu;
+            lam[n] = jobs[i].lam;
+            n++;
+        }
+
+    printf("width %d: %d/%d orbits closed", width, n, nseeds);
+    if (failed)
+        printf(", %d failed to start (out of memory)", failed);
+    printf("\n");
+    if (n > 0) {
+        qsort(mu, (size_t)n, sizeof(uint64_t), cmp_u64);
+        qsort(lam, (size_t)n, sizeof(uint64_t), cmp_u64);
+        printf("  transient  min %-14llu median %-14llu max %llu\n", (unsigned long long)mu[0], (unsigned long long)mu[n / 2],
+               (unsigned long long)mu[n - 1]);
+        printf("  cycle      min %-14llu median %-14llu max %llu\n", (unsigned long long)lam[0], (unsigned long long)lam[n / 2],
+               (unsigned long long)lam[n - 1]);
+        printf("  cycles     ");
+        for (int i = 0; i < n;) {
+            int k = i;
+            while (k < n && lam[k] == lam[i])
+                k++;
+            printf(" %llu x%d", (unsigned long long)lam[i], k - i);
+            i = k;
+        }
+        printf("\n");
+    }
+
+    free(mu);
+    free(lam);
+    return failed;
+}
+
+int main(int argc, char *argv[]) {
+    int         lo = 32, hi = 40;
+    int         nseeds   = 16;
+    int         nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *ckpt     = "cycles.ckpt";
+
+    if (argc >= 2 && sscanf(argv[1], "%d-%d", &lo, &hi) == 1)
+        hi = lo;
+    if (argc >= 3)
+        nseeds = atoi(argv[2]);
+    if (argc >= 4)
+        nthreads = atoi(argv[3]);
+    if (argc >= 5)
+        ckpt = argv[4];
+    if (argc >= 6)
+        g_max_steps = strtoull(argv[5], NULL, 0);
+
+    if (lo < PRNG30_MIN_WIDTH || hi > PRNG30_MAX_WIDTH || lo > hi) {
+        fprintf(stderr, "widths must be in [%d, %d]\n", PRNG30_MIN_WIDTH, PRNG30_MAX_WIDTH);
+        return 1;
+    }
+    if (nseeds < 1)
+        nseeds = 1;
+    if (nthreads < 1)
+        nthreads = 1;
+
+    g_njobs = (hi - lo + 1) * nseeds;
+    g_jobs  = calloc((size_t)g_njobs, sizeof(job));
+    if (!g_jobs) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    for (int w = lo; w <= hi; w++)
+        for (int s = 0; s < nseeds; s++) {
+            job *j      = &g_jobs[(w - lo) * nseeds + s];
+            j->width    = w;
+            j->seed     = ((uint64_t)s + 1u) * 0x9E3779B97F4A7C15ULL;
+            j->tortoise = calloc((size_t)PRNG30_WORDS(w), sizeof(uint64_t));
+            j->hare     = calloc((size_t)PRNG30_WORDS(w), sizeof(uint64_t));
+            if (!j->tortoise || !j->hare) {
+                fprintf(stderr, "out of memory\n");
+                return 1;
+            }
+        }
+
+    load_checkpoint(ckpt);
+
+    pthread_t *threads = calloc((size_t)nthreads, sizeof(pthread_t));
+    if (!threads) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    g_running = nthreads;
+    for (int i = 0; i < nthreads; i++)
+        pthread_create(&threads[i], NULL, worker, NULL);
+
+    time_t last = time(NULL);
+    for (;;) {
+        pthread_mutex_lock(&g_lock);
+        int running = g_running;
+        pthread_mutex_unlock(&g_lock);
+        if (!running)
+            break;
+        sleep(1);
+        if (time(NULL) - last >= CKPT_PERIOD) {
+            save_checkpoint(ckpt);
+            last = time(NULL);
+        }
+    }
+
+    for (int i = 0; i < nthreads; i++)
+        pthread_join(threads[i], NULL);
+    save_checkpoint(ckpt);
+
+    printf("prng30 cycle structure  seeds/width=%d  max_steps=%llu\n\n", nseeds, (unsigned long long)g_max_steps);
+    int failed = 0;
+    for (int w = lo; w <= hi; w++)
+        failed += report_width(w, nseeds, &g_jobs[(w - lo) * nseeds]);
+
+    for (int i = 0; i < g_njobs; i++) {
+        free(g_jobs[i].tortoise);
+        free(g_jobs[i].hare);
+    }
+    free(g_jobs);
+    free(threads);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+#include "../include/prng30.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+//  Hybrid mode against plain mode: output throughput per width, and the
+//  cost of prng30_jump against jump distance.
+
+//  Usage:
+//    ./jump_bench [jump_width]
+
+//    jump_width : width used for the jump timings (def: 256)
+
+//  Columns, first table:
+//    plain   : prng30_fill throughput of a prng30_init state
+//    hybrid  : the same for a prng30_init_hybrid state
+//    ratio   : hybrid / plain
+
+//  Columns, second table:
+//    distance : output bits skipped per jump
+//    jump     : time per prng30_jump, from random positions in a block
+//    generate : time to produce the same bits, extrapolated from throughput
+
+//  Example:
+//    ./jump_bench 4096
+
+#define MIN_SECONDS 0.2
+
+static volatile uint8_t g_sink;
+
+static double now(void) {
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// Bytes per second of prng30_fill.
+static double throughput(int width, int hybrid) {
+    uint8_t      buf[4096];
+    uint64_t     bytes = 0;
+    double       t0    = now(), t;
+    prng30_state st;
+
+    if (hybrid)
+        prng30_init_hybrid(&st, 1, width);
+    else
+        prng30_init(&st, 1, width);
+    do {
+        prng30_fill(&st, buf, sizeof(buf));
+        bytes += sizeof(buf);
+        t = now() - t0;
+    } while (t < MIN_SECONDS);
+    prng30_free(&st);
+    g_sink = buf[0];
+    return (double)bytes / t;
+}
+
+// Seconds per jump of the given distance.
+static double time_jump(int width, uint64_t distance) {
+    uint64_t     calls = 0;
+    double       t0    = now(), t;
+    prng30_state st;
+    prng30_init_hybrid(&st, 1, width);
+    do {
+        // Spread the starting offset over the block so the walk after the
+        // jump is representative.
+        prng30_jump(&st, distance + (calls * 40503u) % PRNG30_HYBRID_BLOCK);
+        calls++;
+        t = now() - t0;
+    } while (t < MIN_SECONDS);
+    prng30_free(&st);
+    return t / (double)calls;
+}
+
+int main(int argc, char *argv[]) {
+    int jump_width = 256;
+    if (argc >= 2)
+        jump_width = atoi(argv[1]);
+
+    if (jump_width < PRNG30_MIN_WIDTH || jump_width > PRNG30_MAX_WIDTH) {
+        fprintf(stderr, "width must be in [%d, %d]\n", PRNG30_MIN_WIDTH, PRNG30_MAX_WIDTH);
+        return 1;
+    }
+
+    static const int widths[] = {32, 64, 128, 256, 512, 1024, 2048, 4096};
+
+    printf("Output throughput, prng30_fill\n\n");
+    printf("%6s  %12s  %12s  %7s\n", "width", "plain MB/s", "hybrid MB/s", "ratio");
+    for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++) {
+        double plain  = throughput(widths[i], 0);
+        double hybrid = throughput(widths[i], 1);
+        printf("%6d  %12.2f  %12.2f  %7.2f\n", widths[i], plain * 1e-6, hybrid * 1e-6, hybrid / plain);
+    }
+
+    double bits_per_sec = 8.0 * throughput(jump_width, 1);
+
+    printf("\nprng30_jump, width %d\n\n", jump_width);
+    printf("%22s  %12s  %14s\n", "distance (bits)", "jump", "generate");
+    static const uint64_t distances[] = {1000ULL, 1000000ULL, 1000000000ULL, 1000000000000ULL, 1000000000000000000ULL};
+    for (size_t i = 0; i < sizeof(distances) / sizeof(distances[0]); i++) {
+        double jump = time_jump(jump_width, distances[i]);
+        double gen  = (double)distances[i] / bits_per_sec;
+        printf("%22llu  %9.1f us  %11.3g s\n", (unsigned long long)distances[i], jump * 1e6, gen);
+    }
+
+    return 0;
+}
@@ -3,28 +3,35 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 //  Writes 1 million bits (125000 bytes) of PRNG output to a binary file.
 //  NIST STS default sequence length is 1,000,000 bits.
 
 //  Usage:
-//    ./nist_dump [width] [output_file]
+//    ./nist_dump [width] [output_file] [mode]
+
+//  mode is plain (default) or hybrid.
 
 //  Example:
 //    ./nist_dump 64  nist_w64.bin
 //    ./nist_dump 128 nist_w128.bin
+//    ./nist_dump 64  nist_w64h.bin hybrid
 
 #define NIST_BYTES (131072 * 100)
 
 int main(int argc, char *argv[]) {
     int         width   = 64;
     const char *outfile = "nist_output.bin";
+    int         hybrid  = 0;
 
     if (argc >= 2)
         width = atoi(argv[1]);
     if (argc >= 3)
         outfile = argv[2];
+    if (argc >= 4)
+        hybrid = strcmp(argv[3], "hybrid") == 0;
 
     if (width < PRNG30_MIN_WIDTH || width > PRNG30_MAX_WIDTH) {
         fprintf(stderr, "width must be in [%d, %d]\n", PRNG30_MIN_WIDTH, PRNG30_MAX_WIDTH);
@@ -38,7 +45,8 @@ int main(int argc, char *argv[]) {
     }
 
     prng30_state st;
-    prng30_err   err = prng30_init(&st, (uint64_t)time(NULL), width);
+    uint64_t     seed = (uint64_t)time(NULL);
+    prng30_err   err  = hybrid ? prng30_init_hybrid(&st, seed, width) : prng30_init(&st, seed, width);
     if (err != PRNG30_OK) {
         fprintf(stderr, "prng30_init failed: %d\n", err);
         fclose(f);
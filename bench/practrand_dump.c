@@ -7,20 +7,25 @@
 #include <time.h>
 
 //  Usage:
-//    ./practrand_dump [width] | RNG_test stdin
-//    ./practrand_dump [width] | RNG_test stdin32
+//    ./practrand_dump [width] [mode] | RNG_test stdin
+//    ./practrand_dump [width] [mode] | RNG_test stdin32
 
-//  width defaults to 64. Writes 64-bit values as raw bytes to stdout.
-//  Pipe directly into PractRand; it will stop reading when it decides.
+//  width defaults to 64, mode to plain (or: hybrid). Writes 64-bit values
+//  as raw bytes to stdout. Pipe directly into PractRand; it will stop
+//  reading when it decides.
 
 //  Example:
 //    ./practrand_dump 64  | RNG_test stdin -tlmax 1TB
 //    ./practrand_dump 128 | RNG_test stdin -tlmax 1TB
+//    ./practrand_dump 64 hybrid | RNG_test stdin -tlmax 1TB
 
 int main(int argc, char *argv[]) {
-    int width = 64;
+    int width  = 64;
+    int hybrid = 0;
     if (argc >= 2)
         width = atoi(argv[1]);
+    if (argc >= 3)
+        hybrid = strcmp(argv[2], "hybrid") == 0;
 
     if (width < PRNG30_MIN_WIDTH || width > PRNG30_MAX_WIDTH) {
         fprintf(stderr, "width must be in [%d, %d]\n", PRNG30_MIN_WIDTH, PRNG30_MAX_WIDTH);
@@ -30,7 +35,7 @@ int main(int argc, char *argv[]) {
     uint64_t seed = (uint64_t)time(NULL);
 
     prng30_state st;
-    prng30_err   err = prng30_init(&st, seed, width);
+    prng30_err   err = hybrid ? prng30_init_hybrid(&st, seed, width) : prng30_init(&st, seed, width);
     if (err != PRNG30_OK) {
         fprintf(stderr, "prng30_init failed: %d\n", err);
         return 1;
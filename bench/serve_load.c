@@ -0,0 +1,180 @@
+#include "../include/prng30_serve.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//  Load test for prng30d: many concurrent clients, each timing every
+//  prng30_client_fill it makes. Start the server first.
+
+//  Usage:
+//    ./serve_load [socket] [connections] [requests] [bytes] [width]
+
+//    socket      : def: /tmp/prng30.sock
+//    connections : concurrent clients, one thread each (def: 64)
+//    requests    : fills per client (def: 2000)
+//    bytes       : bytes per fill (def: 4096, one round trip each)
+//    width       : def: 64
+
+//  Output:
+//    p50, p99, max : latency of one fill, over every client's fills
+//    throughput    : all bytes received / wall time, and fills per second
+//    cold start    : what one short-lived process pays for its first
+//                    bytes, prng30_init + fill against connect + fill
+
+//  Example:
+//    ./prng30d &
+//    ./serve_load /tmp/prng30.sock 256 1000 4096
+
+typedef struct {
+    const char *path;
+    int         width;
+    int         requests;
+    size_t      bytes;
+    double     *lat; // this client's latencies, seconds
+    int         failed;
+} client_job;
+
+#define COLD_BYTES 256
+
+static pthread_barrier_t g_start;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static void *run_client(void *arg) {
+    client_job    *job = arg;
+    prng30_client *c   = NULL;
+    uint8_t       *buf = malloc(job->bytes);
+
+    job->failed = !buf || prng30_client_connect(&c, job->path, job->width) != PRNG30_OK;
+    pthread_barrier_wait(&g_start);
+    for (int i = 0; i < job->requests && !job->failed; i++) {
+        double t0   = now();
+        job->failed = prng30_client_fill(c, buf, job->bytes) != PRNG30_OK;
+        job->lat[i] = now() - t0;
+    }
+    prng30_client_close(c);
+    free(buf);
+    return NULL;
+}
+
+// Time to a process's first COLD_BYTES bytes: a local prng30_init + fill,
+// and a connect + fill. A first request creates the server's generator
+// for the width, and a pause lets its reserve fill, before timing.
+static prng30_err cold_start(const char *path, int width, double *local, double *served) {
+    uint8_t         buf[COLD_BYTES];
+    prng30_state    st;
+    prng30_client  *c;
+    struct timespec pause = {0, 200000000};
+
+    prng30_err err = prng30_client_connect(&c, path, width);
+    if (err == PRNG30_OK)
+        err = prng30_client_fill(c, buf, sizeof(buf));
+    prng30_client_close(c);
+    if (err != PRNG30_OK)
+        return err;
+    nanosleep(&pause, NULL);
+
+    double t0 = now();
+    prng30_init(&st, 1, width);
+    prng30_fill(&st, buf, sizeof(buf));
+    double t1 = now();
+
+    err = prng30_client_connect(&c, path, width);
+    if (err == PRNG30_OK)
+        err = prng30_client_fill(c, buf, sizeof(buf));
+    double t2 = now();
+    prng30_client_close(c);
+    prng30_free(&st);
+
+    *local  = t1 - t0;
+    *served = t2 - t1;
+    return err;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[]) {
+    const char *path     = PRNG30_SERVE_DEFAULT_PATH;
+    int         nconn    = 64;
+    int         requests = 2000;
+    size_t      bytes    = 4096;
+    int         width    = 64;
+
+    if (argc >= 2)
+        path = argv[1];
+    if (argc >= 3)
+        nconn = atoi(argv[2]);
+    if (argc >= 4)
+        requests = atoi(argv[3]);
+    if (argc >= 5)
+        bytes = (size_t)strtoull(argv[4], NULL, 10);
+    if (argc >= 6)
+        width = atoi(argv[5]);
+    if (nconn < 1 || requests < 1 || bytes < 1) {
+        fprintf(stderr, "connections, requests and bytes must be positive\n");
+        return 1;
+    }
+
+    // Cold start, as a short-lived process sees it, against an idle server
+    // whose generator for this width already exists.
+    double cold_local, cold_served;
+    if (cold_start(path, width, &cold_local, &cold_served) != PRNG30_OK) {
+        fprintf(stderr, "cannot reach a server on %s\n", path);
+        return 1;
+    }
+
+    client_job *jobs    = calloc((size_t)nconn, sizeof(*jobs));
+    pthread_t  *threads = calloc((size_t)nconn, sizeof(*threads));
+    double     *lat     = calloc((size_t)nconn * (size_t)requests, sizeof(*lat));
+    if (!jobs || !threads || !lat) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    pthread_barrier_init(&g_start, NULL, (unsigned)nconn + 1);
+    for (int i = 0; i < nconn; i++) {
+        jobs[i] = (client_job){path, width, requests, bytes, lat + (size_t)i * (size_t)requests, 0};
+        if (pthread_create(&threads[i], NULL, run_client, &jobs[i]) != 0) {
+            fprintf(stderr, "cannot start client thread %d\n", i);
+            return 1;
+        }
+    }
+
+    pthread_barrier_wait(&g_start);
+    double t0 = now();
+    for (int i = 0; i < nconn; i++)
+        pthread_join(threads[i], NULL);
+    double wall = now() - t0;
+
+    for (int i = 0; i < nconn; i++)
+        if (jobs[i].failed) {
+            fprintf(stderr, "client %d failed; is the server running on %s?\n", i, path);
+            return 1;
+        }
+
+    size_t total = (size_t)nconn * (size_t)requests;
+    qsort(lat, total, sizeof(*lat), cmp_double);
+    printf("%d connections x %d fills of %zu bytes, width %d\n\n", nconn, requests, bytes, width);
+    printf("latency     p50 %8.1f us   p99 %8.1f us   max %8.1f us\n", lat[total / 2] * 1e6, lat[total * 99 / 100] * 1e6,
+           lat[total - 1] * 1e6);
+    printf("throughput  %8.1f MB/s   %10.0f fills/s\n", (double)(total * bytes) / wall * 1e-6, (double)total / wall);
+    printf("cold start  prng30_init + fill %8.1f us   connect + fill %8.1f us   (%d bytes)\n", cold_local * 1e6,
+           cold_served * 1e6, COLD_BYTES);
+
+    pthread_barrier_destroy(&g_start);
+    free(jobs);
+    free(threads);
+    free(lat);
+    return 0;
+}
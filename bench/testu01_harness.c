@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include <bbattery.h>
@@ -12,21 +13,56 @@
 //  The generator function must return a double in [0, 1).
 
 //  Usage:
-//    ./testu01_harness [width] [battery]
+//    ./testu01_harness [width] [battery] [seed] [mode]
 
 //    width   : automaton width (def: 64)
 //    battery : 0 = SmallCrush (fast, ~10 min)
 //              1 = Crush       (medium, ~2 hrs)
 //              2 = BigCrush    (full, ~6 hrs)
+//    seed    : def: time-based
+//    mode    : plain (def) or hybrid
 
 //  Example:
 //    ./testu01_harness 64 0    # SmallCrush, width 64
 //    ./testu01_harness 128 2   # BigCrush, width 128
+//    ./testu01_harness 64 1 7 hybrid
+
+//  To run many widths, seeds and batteries across all cores, use
+//  testu01_runner, which launches this program once per job.
+
+// Values are cut in bulk from one prng30_fill call per refill and handed
+// out one per callback, so the per-call cost inside TestU01 is an array
+// read. Value i is bits [53i, 53i + 53) of the byte stream, MSB first,
+// the same double prng30_generate_double would return.
+#define BULK_DOUBLES 65536
+#define BULK_BYTES (BULK_DOUBLES * 53 / 8)
 
 static prng30_state g_st;
+static uint8_t      g_raw[BULK_BYTES + 8]; // slack for the last 8-byte load
+static double       g_buf[BULK_DOUBLES];
+static size_t       g_pos = BULK_DOUBLES;
+
+static uint64_t load_be64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+static void refill(void) {
+    prng30_fill(&g_st, g_raw, BULK_BYTES);
+    for (size_t i = 0; i < BULK_DOUBLES; i++) {
+        size_t   bit = 53 * i;
+        uint64_t k   = (load_be64(g_raw + bit / 8) << (bit % 8)) >> 11;
+        g_buf[i]     = (double)k * (1.0 / 9007199254740992.0);
+    }
+    g_pos = 0;
+}
 
 static double prng30_testu01(void) {
-    return prng30_generate_double(&g_st);
+    if (g_pos == BULK_DOUBLES)
+        refill();
+    return g_buf[g_pos++];
 }
 
 static unsigned long prng30_testu01_bits(void) {
@@ -34,13 +70,19 @@ static unsigned long prng30_testu01_bits(void) {
 }
 
 int main(int argc, char *argv[]) {
-    int width   = 64;
-    int battery = 0;
+    int      width   = 64;
+    int      battery = 0;
+    uint64_t seed    = (uint64_t)time(NULL);
+    int      hybrid  = 0;
 
     if (argc >= 2)
         width = atoi(argv[1]);
     if (argc >= 3)
         battery = atoi(argv[2]);
+    if (argc >= 4)
+        seed = (uint64_t)strtoull(argv[3], NULL, 0);
+    if (argc >= 5)
+        hybrid = strcmp(argv[4], "hybrid") == 0;
 
     if (width < PRNG30_MIN_WIDTH || width > PRNG30_MAX_WIDTH) {
         fprintf(stderr, "width must be in [%d, %d]\n", PRNG30_MIN_WIDTH, PRNG30_MAX_WIDTH);
@@ -52,18 +94,19 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    prng30_err err = prng30_init(&g_st, (uint64_t)time(NULL), width);
+    prng30_err err = hybrid ? prng30_init_hybrid(&g_st, seed, width) : prng30_init(&g_st, seed, width);
     if (err != PRNG30_OK) {
         fprintf(stderr, "prng30_init failed: %d\n", err);
         return 1;
     }
 
     char name[64];
-    snprintf(name, sizeof(name), "prng30_w%d", width);
+    snprintf(name, sizeof(name), "prng30_w%d%s", width, hybrid ? "_hybrid" : "");
 
     unif01_Gen *gen = unif01_CreateExternGen01(name, prng30_testu01);
 
-    printf("prng30  width=%d  battery=%s\n\n", width, battery == 0 ? "SmallCrush" : battery == 1 ? "Crush" : "BigCrush");
+    printf("prng30  width=%d  mode=%s  battery=%s  seed=%llu\n\n", width, hybrid ? "hybrid" : "plain",
+           battery == 0 ? "SmallCrush" : battery == 1 ? "Crush" : "BigCrush", (unsigned long long)seed);
 
     switch (battery) {
     case 0:
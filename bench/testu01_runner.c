@@ -0,0 +1,279 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+//  Runs testu01_harness for every width x battery x seed combination,
+//  one process per job, keeping up to `jobs` of them busy at once.
+//  Each job writes its report into the results tree:
+
+//    <results>/small_crush/w64.txt        (one seed)
+//    <results>/crush/w64_s2.txt           (several seeds: _s<index>)
+
+//  and a summary table of all jobs is written to <results>/summary.txt.
+//  Reports are written to a .part file and renamed on success, so an
+//  interrupted run never leaves a truncated report behind.
+
+//  Usage:
+//    ./testu01_runner [widths] [batteries] [seeds] [jobs] [harness] [results]
+
+//    widths    : comma-separated list (def: 32,64,128,256)
+//    batteries : comma-separated list of 0/1/2 (def: 0)
+//    seeds     : seeds per width and battery (def: 1)
+//    jobs      : concurrent processes (def: online CPUs)
+//    harness   : path to testu01_harness (def: ./testu01_harness)
+//    results   : results directory (def: bench/results/testu01)
+
+//  Seeds are 1, 2, ... so every report can be reproduced with
+//  ./testu01_harness <width> <battery> <seed>.
+
+//  Example:
+//    ./testu01_runner 32,64,128,256 1,2 1 16
+
+#define MAX_LIST 64
+
+static const char *const battery_dir[3]  = {"small_crush", "crush", "big_crush"};
+static const char *const battery_name[3] = {"SmallCrush", "Crush", "BigCrush"};
+
+typedef struct {
+    int    width;
+    int    battery;
+    int    seed_index;
+    pid_t  pid;
+    int    status; // 0 pending, 1 running, 2 finished, 3 failed
+    time_t start;
+    time_t end;
+    char   path[1024];
+} job;
+
+static int parse_list(const char *s, int *out, int max) {
+    int n = 0;
+    while (*s && n < max) {
+        char *end;
+        long  v = strtol(s, &end, 10);
+        if (end == s)
+            break;
+        out[n++] = (int)v;
+        s        = (*end == ',') ? end + 1 : end;
+    }
+    return n;
+}
+
+static int make_dir(const char *path) {
+    char buf[1024];
+    snprintf(buf, sizeof(buf), "%s", path);
+    for (char *p = buf + 1; *p; p++)
+        if (*p == '/') {
+            *p = '\0';
+            if (mkdir(buf, 0755) != 0 && errno != EEXIST)
+                return -1;
+            *p = '/';
+        }
+    if (mkdir(buf, 0755) != 0 && errno != EEXIST)
+        return -1;
+    return 0;
+}
+
+static pid_t launch(job *j, const char *harness) {
+    char part[1100];
+    snprintf(part, sizeof(part), "%s.part", j->path);
+
+    pid_t pid = fork();
+    if (pid != 0)
+        return pid;
+
+    int fd = open(part, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "cannot open %s\n", part);
+        _exit(127);
+    }
+    dup2(fd, STDOUT_FILENO);
+    dup2(fd, STDERR_FILENO);
+    close(fd);
+
+    char width[16], battery[16], seed[32];
+    snprintf(width, sizeof(width), "%d", j->width);
+    snprintf(battery, sizeof(battery), "%d", j->battery);
+    snprintf(seed, sizeof(seed), "%d", j->seed_index + 1);
+
+    execl(harness, harness, width, battery, seed, (char *)NULL);
+    fprintf(stderr, "cannot exec %s\n", harness);
+    _exit(127);
+}
+
+// Pull the headline numbers out of a TestU01 summary block. bbattery ends
+// it either with "All tests were passed" or with "The following tests gave
+// p-values outside [0.001, 0.9990]:" and a table between two dashed rules,
+// one line per failing statistic.
+static void summarise(const job *j, FILE *out) {
+    char line[512];
+    int  stats = -1, failed = 0, table = 0, passed = 0;
+    char cpu[32] = "-";
+
+    FILE *f = (j->status == 2) ? fopen(j->path, "r") : NULL;
+    if (f) {
+        while (fgets(line, sizeof(line), f)) {
+            const char *t = line + strspn(line, " \t");
+            if (sscanf(t, "Number of statistics: %d", &stats) == 1)
+                continue;
+            if (sscanf(t, "Total CPU time: %31s", cpu) == 1)
+                continue;
+            if (strncmp(t, "All tests were passed", 21) == 0)
+                passed = 1;
+            else if (table == 0 && strncmp(t, "The following tests gave p-values outside", 41) == 0)
+                table = 1; // the column header and a dashed rule follow
+            else if (table > 0 && strncmp(t, "------", 6) == 0)
+                table++; // 2: inside the table, 3: past it
+            else if (table == 2)
+                failed++;
+        }
+        fclose(f);
+    }
+
+    const char *verdict = (j->status != 2) ? "error" : (failed > 0) ? "FAIL" : (stats < 0 || !passed) ? "incomplete" : "pass";
+
+    fprintf(out, "%-10s  %5d  %4d  %5d  %6d  %12s  %6lds  %s\n", battery_name[j->battery], j->width, j->seed_index + 1, stats, failed, cpu,
+            (long)(j->end - j->start), verdict);
+}
+
+int main(int argc, char *argv[]) {
+    int         widths[MAX_LIST]    = {32, 64, 128, 256};
+    int         batteries[MAX_LIST] = {0};
+    int         nwidths = 4, nbatteries = 1, nseeds = 1;
+    int         maxjobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *harness = "./testu01_harness";
+    const char *results = "bench/results/testu01";
+
+    if (argc >= 2)
+        nwidths = parse_list(argv[1], widths, MAX_LIST);
+    if (argc >= 3)
+        nbatteries = parse_list(argv[2], batteries, MAX_LIST);
+    if (argc >= 4)
+        nseeds = atoi(argv[3]);
+    if (argc >= 5)
+        maxjobs = atoi(argv[4]);
+    if (argc >= 6)
+        harness = argv[5];
+    if (argc >= 7)
+        results = argv[6];
+
+    if (nwidths < 1 || nbatteries < 1 || nseeds < 1) {
+        fprintf(stderr, "nothing to run\n");
+        return 1;
+    }
+    for (int b = 0; b < nbatteries; b++)
+        if (batteries[b] < 0 || batteries[b] > 2) {
+            fprintf(stderr, "battery must be 0 (SmallCrush), 1 (Crush), or 2 (BigCrush)\n");
+            return 1;
+        }
+    if (access(harness, X_OK) != 0) {
+        fprintf(stderr, "cannot execute %s (build with TestU01 installed)\n", harness);
+        return 1;
+    }
+    if (maxjobs < 1)
+        maxjobs = 1;
+
+    int  njobs = nwidths * nbatteries * nseeds;
+    job *jobs  = calloc((size_t)njobs, sizeof(job));
+    if (!jobs) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    // Longest batteries first so the short jobs fill in around them.
+    for (int b = 1; b < nbatteries; b++)
+        for (int k = b; k > 0 && batteries[k] > batteries[k - 1]; k--) {
+            int t            = batteries[k];
+            batteries[k]     = batteries[k - 1];
+            batteries[k - 1] = t;
+        }
+
+    int n = 0;
+    for (int b = 0; b < nbatteries; b++) {
+        int  battery = batteries[b];
+        char dir[768];
+        snprintf(dir, sizeof(dir), "%s/%s", results, battery_dir[battery]);
+        if (make_dir(dir) != 0) {
+            fprintf(stderr, "cannot create %s\n", dir);
+            return 1;
+        }
+        for (int w = 0; w < nwidths; w++)
+            for (int s = 0; s < nseeds; s++) {
+                job *j        = &jobs[n++];
+                j->width      = widths[w];
+                j->battery    = battery;
+                j->seed_index = s;
+                if (nseeds == 1)
+                    snprintf(j->path, sizeof(j->path), "%s/w%d.txt", dir, j->width);
+                else
+                    snprintf(j->path, sizeof(j->path), "%s/w%d_s%d.txt", dir, j->width, s + 1);
+            }
+    }
+
+    int next = 0, running = 0, done = 0;
+    while (done < njobs) {
+        while (running < maxjobs && next < njobs) {
+            job *j   = &jobs[next++];
+            j->start = time(NULL);
+            j->pid   = launch(j, harness);
+            if (j->pid < 0) {
+                j->status = 3;
+                j->end    = j->start;
+                done++;
+                continue;
+            }
+            j->status = 1;
+            running++;
+            fprintf(stderr, "[start] %-10s width=%-5d seed=%d  (%d running)\n", battery_name[j->battery], j->width, j->seed_index + 1,
+                    running);
+        }
+
+        int   wstatus;
+        pid_t pid = wait(&wstatus);
+        if (pid < 0)
+            break;
+
+        for (int i = 0; i < njobs; i++) {
+            job *j = &jobs[i];
+            if (j->status != 1 || j->pid != pid)
+                continue;
+            char part[1100];
+            snprintf(part, sizeof(part), "%s.part", j->path);
+            j->end    = time(NULL);
+            j->status = (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0) ? 2 : 3;
+            if (j->status == 2)
+                rename(part, j->path);
+            running--;
+            done++;
+            fprintf(stderr, "[%s] %-10s width=%-5d seed=%d  %lds  (%d/%d)\n", j->status == 2 ? "done" : "FAIL", battery_name[j->battery],
+                    j->width, j->seed_index + 1, (long)(j->end - j->start), done, njobs);
+        }
+    }
+
+    char summary[1024];
+    snprintf(summary, sizeof(summary), "%s/summary.txt", results);
+    FILE *out = fopen(summary, "w");
+
+    const char *header = "battery     width  seed  stats  failed      cpu time    wall  verdict\n";
+    printf("%s", header);
+    if (out)
+        fprintf(out, "%s", header);
+    for (int i = 0; i < njobs; i++) {
+        summarise(&jobs[i], stdout);
+        if (out)
+            summarise(&jobs[i], out);
+    }
+    if (out) {
+        fclose(out);
+        fprintf(stderr, "summary written to %s\n", summary);
+    }
+
+    free(jobs);
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include "../include/prng30_wide.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+//  Strong scaling of prng30_wide: one automaton of fixed width stepped a
+//  fixed number of generations on 1, 2, 4, ... threads. Every run starts
+//  from the same row and its final row is compared with plain
+//  prng30_step_packed on one core.
+
+//  Usage:
+//    ./wide_scaling [width] [generations] [halo] [max_threads]
+
+//    width       : cells (def: 1000000, max 2^28)
+//    generations : generations per run (def: 2000)
+//    halo        : generations between barriers (def: 512)
+//    max_threads : largest thread count tried (def: online CPUs)
+
+//  Columns:
+//    threads    : threads stepping the row, pinned one per CPU
+//    seconds    : wall time for all generations
+//    Gcells/s   : cell updates per second, width * generations / seconds
+//    speedup    : against 1 thread
+//    efficiency : speedup / threads
+//    exact      : final row identical to prng30_step_packed
+
+//  Example:
+//    ./wide_scaling 10000000 1000 1024 16
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int run(int width, uint64_t gens, int halo, int threads, const uint64_t *start, const uint64_t *want,
+               uint64_t *got, double *seconds) {
+    prng30_wide       *w;
+    prng30_wide_config cfg;
+
+    prng30_wide_default_config(&cfg);
+    cfg.threads = threads;
+    cfg.halo    = halo;
+    cfg.warmup  = 0;
+    cfg.pin     = 1;
+    if (prng30_wide_create(&w, 0, width, &cfg) != PRNG30_OK)
+        return -1;
+
+    prng30_wide_set_row(w, start);
+    double t0 = now();
+    prng30_wide_step(w, gens);
+    *seconds = now() - t0;
+
+    prng30_wide_row(w, got);
+    int used = prng30_wide_threads(w);
+    prng30_wide_destroy(w);
+    return (memcmp(got, want, (size_t)PRNG30_WORDS(width) * sizeof(uint64_t)) == 0) ? used : 0;
+}
+
+int main(int argc, char *argv[]) {
+    int      width       = 1000000;
+    uint64_t gens        = 2000;
+    int      halo        = 512;
+    int      max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (argc >= 2)
+        width = atoi(argv[1]);
+    if (argc >= 3)
+        gens = strtoull(argv[2], NULL, 0);
+    if (argc >= 4)
+        halo = atoi(argv[3]);
+    if (argc >= 5)
+        max_threads = atoi(argv[4]);
+
+    if (width < PRNG30_MIN_WIDTH || width > PRNG30_WIDE_MAX_WIDTH) {
+        fprintf(stderr, "width must be in [%d, %d]\n", PRNG30_MIN_WIDTH, PRNG30_WIDE_MAX_WIDTH);
+        return 1;
+    }
+    if (max_threads < 1)
+        max_threads = 1;
+
+    size_t    bytes = (size_t)PRNG30_WORDS(width) * sizeof(uint64_t);
+    uint64_t *start = malloc(bytes);
+    uint64_t *want  = malloc(bytes);
+    uint64_t *tmp   = malloc(bytes);
+    uint64_t *got   = malloc(bytes);
+    if (!start || !want || !tmp || !got) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    // Starting row: a freshly seeded automaton, without warmup.
+    prng30_wide       *w;
+    prng30_wide_config cfg;
+    prng30_wide_default_config(&cfg);
+    cfg.threads = 1;
+    cfg.warmup  = 0;
+    if (prng30_wide_create(&w, 0x5CA1E, width, &cfg) != PRNG30_OK) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    prng30_wide_row(w, start);
+    prng30_wide_destroy(w);
+
+    memcpy(want, start, bytes);
+    double t0 = now();
+    for (uint64_t g = 0; g < gens; g++) {
+        prng30_step_packed(tmp, want, width);
+        uint64_t *t = want;
+        want        = tmp;
+        tmp         = t;
+    }
+    double base  = now() - t0;
+    double cells = (double)width * (double)gens;
+
+    printf("width %d, %llu generations, halo %d\n\n", width, (unsigned long long)gens, halo);
+    printf("%-10s %10s %10s %9s %11s %6s\n", "threads", "seconds", "Gcells/s", "speedup", "efficiency", "exact");
+    printf("%-10s %10.3f %10.2f\n", "step_packed", base, cells / base * 1e-9);
+
+    double one = 0.0;
+    for (int t = 1; t <= max_threads; t = (t < max_threads && t * 2 > max_threads) ? max_threads : t * 2) {
+        double secs;
+        int    used = run(width, gens, halo, t, start, want, got, &secs);
+        if (used < 0) {
+            fprintf(stderr, "could not create a %d-thread automaton\n", t);
+            return 1;
+        }
+        if (t == 1)
+            one = secs;
+        printf("%-10d %10.3f %10.2f %8.2fx %10.0f%% %6s\n", used ? used : t, secs, cells / secs * 1e-9, one / secs,
+               100.0 * one / secs / (used ? used : t), used ? "yes" : "NO");
+        if (t == max_threads)
+            break;
+    }
+
+    free(start);
+    free(want);
+    free(tmp);
+    free(got);
+    return 0;
+}
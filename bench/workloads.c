@@ -0,0 +1,519 @@
+#include "../include/prng30.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+//  End-to-end workloads on prng30 and on reference generators built here
+//  (xoshiro256**, splitmix64, pcg32): pi estimation, a 2-D random walk,
+//  Metropolis Ising chains, bootstrap resampling and linear-probing hash
+//  table loads. Each workload runs on one thread and on `threads`
+//  threads, every thread with its own generator and an equal share of
+//  the units of work.
+
+//  Draws take only the bits they need (2 per walk step, 10 per index
+//  below 1000, 53 per double), from a per-generator bit reservoir fed by
+//  bulk fills of 4 KiB. The prng30 "generate" rows skip the reservoir
+//  and call prng30_generate(st, nbits) per draw, so the two APIs can be
+//  compared.
+
+//  Usage:
+//    ./workloads [threads] [scale] [json]
+
+//    threads : threads for the multi-threaded runs (def: online CPUs)
+//    scale   : multiplies every workload's size (def: 1)
+//    json    : results file (def: workloads.json)
+
+//  Columns:
+//    seconds   : wall time to solution
+//    units/s   : units of work per second
+//    bits/unit : random bits consumed per unit of work
+//    result    : the workload's estimate, and what it should be close to
+
+//  Example:
+//    ./workloads 16 10 results.json
+
+#define BUF_WORDS 512
+#define SEED 20240917ULL
+
+// --- generators -------------------------------------------------------
+
+enum { API_FILL, API_GENERATE, API_REF };
+
+typedef struct gen gen;
+
+typedef struct {
+    const char *name;
+    const char *api;
+    int         kind;
+    int         width; // prng30 only
+    int         hybrid;
+    void (*seed)(gen *g, uint64_t seed);
+    void (*refill)(gen *g);
+} gen_kind;
+
+struct gen {
+    const gen_kind *kind;
+    prng30_state    st;
+    uint64_t        s[4];
+    uint64_t        acc;  // reservoir: the top `have` bits are unused
+    int             have;
+    size_t          pos;
+    uint64_t        bits; // consumed so far
+    uint64_t        buf[BUF_WORDS];
+};
+
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static void seed_prng30(gen *g, uint64_t seed) {
+    if (g->kind->hybrid)
+        prng30_init_hybrid(&g->st, seed, g->kind->width);
+    else
+        prng30_init(&g->st, seed, g->kind->width);
+}
+
+static void refill_prng30(gen *g) {
+    prng30_fill(&g->st, g->buf, sizeof(g->buf));
+}
+
+static void seed_ref(gen *g, uint64_t seed) {
+    for (int i = 0; i < 4; i++)
+        g->s[i] = splitmix64(&seed);
+}
+
+static void refill_xoshiro(gen *g) {
+    uint64_t *s = g->s;
+    for (int i = 0; i < BUF_WORDS; i++) {
+        g->buf[i]  = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+    }
+}
+
+static void refill_splitmix(gen *g) {
+    for (int i = 0; i < BUF_WORDS; i++)
+        g->buf[i] = splitmix64(&g->s[0]);
+}
+
+// pcg32 (XSH RR), two outputs per word; s[1] is the odd increment.
+static uint32_t pcg32(gen *g) {
+    uint64_t old = g->s[0];
+    g->s[0]      = old * 6364136223846793005ULL + (g->s[1] | 1);
+    uint32_t x   = (uint32_t)(((old >> 18) ^ old) >> 27);
+    unsigned r   = (unsigned)(old >> 59);
+    return (x >> r) | (x << ((32 - r) & 31));
+}
+
+static void refill_pcg(gen *g) {
+    for (int i = 0; i < BUF_WORDS; i++) {
+        uint64_t hi = pcg32(g);
+        g->buf[i]   = (hi << 32) | pcg32(g);
+    }
+}
+
+static const gen_kind g_kinds[] = {
+    {"prng30-64", "generate", API_GENERATE, 64, 0, seed_prng30, NULL},
+    {"prng30-64", "fill", API_FILL, 64, 0, seed_prng30, refill_prng30},
+    {"prng30-256", "fill", API_FILL, 256, 0, seed_prng30, refill_prng30},
+    {"prng30-64-hybrid", "fill", API_FILL, 64, 1, seed_prng30, refill_prng30},
+    {"xoshiro256**", "fill", API_REF, 0, 0, seed_ref, refill_xoshiro},
+    {"splitmix64", "fill", API_REF, 0, 0, seed_ref, refill_splitmix},
+    {"pcg32", "fill", API_REF, 0, 0, seed_ref, refill_pcg},
+};
+
+static void gen_init(gen *g, const gen_kind *kind, uint64_t seed) {
+    memset(g, 0, sizeof(*g));
+    g->kind = kind;
+    g->pos  = BUF_WORDS;
+    kind->seed(g, seed);
+}
+
+static void gen_free(gen *g) {
+    if (g->kind->width)
+        prng30_free(&g->st);
+}
+
+static uint64_t next_word(gen *g) {
+    if (g->pos == BUF_WORDS) {
+        g->kind->refill(g);
+        g->pos = 0;
+    }
+    return g->buf[g->pos++];
+}
+
+// The next n bits, 1 <= n <= 64.
+static inline uint64_t take(gen *g, int n) {
+    g->bits += (uint64_t)n;
+    if (g->kind->kind == API_GENERATE)
+        return prng30_generate(&g->st, n);
+
+    if (g->have >= n) {
+        uint64_t v = g->acc >> (64 - n);
+        g->acc     = (n < 64) ? g->acc << n : 0;
+        g->have -= n;
+        return v;
+    }
+    // Use up the reservoir, then continue into a fresh word.
+    int      need = n - g->have;
+    uint64_t v    = g->have ? (g->acc >> (64 - g->have)) << need : 0;
+    uint64_t w    = next_word(g);
+    v |= w >> (64 - need);
+    g->acc  = (need < 64) ? w << need : 0;
+    g->have = 64 - need;
+    return v;
+}
+
+static inline double take_double(gen *g) {
+    return (double)take(g, 53) * (1.0 / 9007199254740992.0);
+}
+
+// Uniform in [0, n) by masked rejection: ceil(log2 n) bits per try.
+static inline uint64_t take_below(gen *g, uint64_t n) {
+    int k = 1;
+    while (k < 64 && (1ULL << k) < n)
+        k++;
+    uint64_t v;
+    do
+        v = take(g, k);
+    while (v >= n);
+    return v;
+}
+
+// --- workloads ----------------------------------------------------------
+
+#define WALK_STEPS 1000
+#define ISING_L 32
+#define ISING_SWEEPS 200
+#define ISING_T 2.0
+#define BOOT_N 1000
+#define HASH_BITS 16
+#define HASH_LOAD 0.9
+
+typedef struct {
+    double sum;
+    double sum2;
+    int    failed; // out of memory; the run is skipped
+} partial;
+
+typedef struct {
+    const char *name;
+    const char *unit;
+    long        units; // at scale 1
+    partial (*run)(gen *g, long units);
+    double (*result)(partial p, long units);
+    double expected;
+} workload;
+
+static double g_boot_data[BOOT_N];
+
+static partial run_pi(gen *g, long units) {
+    partial p = {0, 0, 0};
+    for (long i = 0; i < units; i++) {
+        double x = take_double(g), y = take_double(g);
+        p.sum += (x * x + y * y < 1.0);
+    }
+    return p;
+}
+
+static double result_pi(partial p, long units) {
+    return 4.0 * p.sum / (double)units;
+}
+
+static partial run_walk(gen *g, long units) {
+    static const int dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+    partial          p     = {0, 0, 0};
+    for (long i = 0; i < units; i++) {
+        long x = 0, y = 0;
+        for (int s = 0; s < WALK_STEPS; s++) {
+            uint64_t d = take(g, 2);
+            x += dx[d];
+            y += dy[d];
+        }
+        p.sum += (double)(x * x + y * y);
+    }
+    return p;
+}
+
+// Mean squared displacement per step; 1 for a lattice walk.
+static double result_walk(partial p, long units) {
+    return p.sum / ((double)units * WALK_STEPS);
+}
+
+// One Metropolis chain per unit from the ordered state, typewriter
+// sweeps, mean |magnetisation| over the second half of the sweeps.
+static partial run_ising(gen *g, long units) {
+    partial  p = {0, 0, 0};
+    int8_t   spin[ISING_L][ISING_L];
+    uint64_t accept[9] = {0};
+
+    // Flips that raise the energy by dE are accepted with exp(-dE / T),
+    // compared as 53-bit integers.
+    for (int de = 4; de <= 8; de += 4)
+        accept[de] = (uint64_t)(exp(-de / ISING_T) * 9007199254740992.0);
+
+    for (long c = 0; c < units; c++) {
+        memset(spin, 1, sizeof(spin));
+        double mag = 0;
+        for (int sweep = 0; sweep < ISING_SWEEPS; sweep++) {
+            for (int i = 0; i < ISING_L; i++)
+                for (int j = 0; j < ISING_L; j++) {
+                    int nb = spin[(i + 1) % ISING_L][j] + spin[(i + ISING_L - 1) % ISING_L][j] + spin[i][(j + 1) % ISING_L] +
+                             spin[i][(j + ISING_L - 1) % ISING_L];
+                    int de = 2 * spin[i][j] * nb;
+                    if (de <= 0 || take(g, 53) < accept[de])
+                        spin[i][j] = (int8_t)-spin[i][j];
+                }
+            if (sweep >= ISING_SWEEPS / 2) {
+                long m = 0;
+                for (int i = 0; i < ISING_L; i++)
+                    for (int j = 0; j < ISING_L; j++)
+                        m += spin[i][j];
+                mag += fabs((double)m) / (ISING_L * ISING_L);
+            }
+        }
+        p.sum += mag / (ISING_SWEEPS - ISING_SWEEPS / 2);
+    }
+    return p;
+}
+
+static double result_mean(partial p, long units) {
+    return p.sum / (double)units;
+}
+
+// One resample of the data per unit; the result is the standard
+// deviation of the resampled means, i.e. the bootstrap standard error.
+static partial run_boot(gen *g, long units) {
+    partial p = {0, 0, 0};
+    for (long b = 0; b < units; b++) {
+        double s = 0;
+        for (int i = 0; i < BOOT_N; i++)
+            s += g_boot_data[take_below(g, BOOT_N)];
+        s /= BOOT_N;
+        p.sum += s;
+        p.sum2 += s * s;
+    }
+    return p;
+}
+
+static double result_boot(partial p, long units) {
+    double mean = p.sum / (double)units;
+    return sqrt(p.sum2 / (double)units - mean * mean);
+}
+
+// One table per unit: random keys into 2^HASH_BITS slots by linear
+// probing until HASH_LOAD full. The result is slots probed per insert.
+static partial run_hash(gen *g, long units) {
+    partial   p     = {0, 0, 0};
+    size_t    size  = (size_t)1 << HASH_BITS;
+    long      keys  = (long)(HASH_LOAD * (double)size);
+    uint64_t *table = malloc(size * sizeof(*table));
+    if (!table) {
+        p.failed = 1;
+        return p;
+    }
+
+    for (long t = 0; t < units; t++) {
+        memset(table, 0, size * sizeof(*table));
+        for (long k = 0; k < keys; k++) {
+            uint64_t key = take(g, 64) | 1; // 0 marks an empty slot
+            size_t   i   = (size_t)(key >> (64 - HASH_BITS));
+            p.sum += 1;
+            while (table[i]) {
+                i = (i + 1) & (size - 1);
+                p.sum += 1;
+            }
+            table[i] = key;
+        }
+        p.sum2 += (double)keys;
+    }
+    free(table);
+    return p;
+}
+
+static double result_hash(partial p, long units) {
+    (void)units;
+    return p.sum / p.sum2;
+}
+
+static workload g_workloads[] = {
+    {"pi", "point", 1L << 19, run_pi, result_pi, 3.14159265358979},
+    {"walk2d", "walker", 4096, run_walk, result_walk, 1.0},
+    {"ising", "chain", 8, run_ising, result_mean, 0.0}, // set in main
+    {"bootstrap", "resample", 4000, run_boot, result_boot, 0.0}, // set in main
+    {"hash", "table", 8, run_hash, result_hash, 0.5 * (1.0 + 1.0 / (1.0 - HASH_LOAD))},
+};
+
+// --- runner -------------------------------------------------------------
+
+typedef struct {
+    const workload *w;
+    const gen_kind *kind;
+    uint64_t        seed;
+    long            units;
+    partial         out;
+    uint64_t        bits;
+} job;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void *run_job(void *arg) {
+    job *j = arg;
+    gen  g;
+    gen_init(&g, j->kind, j->seed);
+    j->out  = j->w->run(&g, j->units);
+    j->bits = g.bits;
+    gen_free(&g);
+    return NULL;
+}
+
+typedef struct {
+    double   seconds;
+    double   result;
+    uint64_t bits;
+} outcome;
+
+// Run w on `threads` threads with equal shares of `units`. Returns -1 if
+// the threads could not be started and -2 if the workload failed; o is
+// then not filled in.
+static int run(const workload *w, const gen_kind *kind, int threads, long units, outcome *o) {
+    job       *jobs = calloc((size_t)threads, sizeof(*jobs));
+    pthread_t *tids = calloc((size_t)threads, sizeof(*tids));
+    uint64_t   mix  = SEED;
+    int        ok   = jobs && tids;
+
+    double t0 = now();
+    for (int t = 0; ok && t < threads; t++) {
+        jobs[t] = (job){w, kind, splitmix64(&mix), units * (t + 1) / threads - units * t / threads, {0, 0, 0}, 0};
+        ok      = pthread_create(&tids[t], NULL, run_job, &jobs[t]) == 0;
+        if (!ok)
+            threads = t;
+    }
+    partial total = {0, 0, 0};
+    o->bits       = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+        total.sum += jobs[t].out.sum;
+        total.sum2 += jobs[t].out.sum2;
+        total.failed |= jobs[t].out.failed;
+        o->bits += jobs[t].bits;
+    }
+    o->seconds = now() - t0;
+    if (ok && !total.failed)
+        o->result = w->result(total, units);
+
+    free(jobs);
+    free(tids);
+    return !ok ? -1 : total.failed ? -2 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    int         threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    double      scale   = 1.0;
+    const char *json    = "workloads.json";
+
+    if (argc >= 2)
+        threads = atoi(argv[1]);
+    if (argc >= 3)
+        scale = atof(argv[2]);
+    if (argc >= 4)
+        json = argv[3];
+    if (threads < 1 || !(scale > 0)) {
+        fprintf(stderr, "threads and scale must be positive\n");
+        return 1;
+    }
+
+    FILE *out = fopen(json, "w");
+    if (!out) {
+        fprintf(stderr, "cannot write %s\n", json);
+        return 1;
+    }
+
+    // Bootstrap data: fixed, so every generator resamples the same set.
+    uint64_t data_seed = SEED;
+    double   mean = 0, var = 0;
+    for (int i = 0; i < BOOT_N; i++) {
+        g_boot_data[i] = (double)(splitmix64(&data_seed) >> 11) * (1.0 / 9007199254740992.0);
+        mean += g_boot_data[i];
+    }
+    mean /= BOOT_N;
+    for (int i = 0; i < BOOT_N; i++)
+        var += (g_boot_data[i] - mean) * (g_boot_data[i] - mean);
+    g_workloads[3].expected = sqrt(var / BOOT_N / BOOT_N);
+
+    // Onsager's spontaneous magnetisation; the 32x32 lattice comes close.
+    g_workloads[2].expected = pow(1.0 - pow(sinh(2.0 / ISING_T), -4.0), 0.125);
+
+    fprintf(out, "{\n  \"scale\": %g,\n  \"threads\": %d,\n  \"results\": [", scale, threads);
+    printf("%-10s %-17s %-8s %3s %9s %10s %10s %12s %10s\n", "workload", "generator", "api", "thr", "seconds", "units/s",
+           "bits/unit", "result", "expected");
+
+    int first = 1, skipped = 0;
+    for (size_t wi = 0; wi < sizeof(g_workloads) / sizeof(g_workloads[0]); wi++) {
+        const workload *w     = &g_workloads[wi];
+        long            units = (long)((double)w->units * scale);
+        if (units < 1)
+            units = 1;
+
+        for (size_t ki = 0; ki < sizeof(g_kinds) / sizeof(g_kinds[0]); ki++) {
+            const gen_kind *k = &g_kinds[ki];
+            for (int t = 1; t <= threads; t = (t == threads) ? threads + 1 : threads) {
+                outcome o;
+                int     rc = run(w, k, t, units, &o);
+                if (rc == -1) {
+                    fprintf(stderr, "cannot start %d threads\n", t);
+                    fclose(out);
+                    return 1;
+                }
+                if (rc == -2) {
+                    // Left out of the JSON rather than written as a NaN.
+                    fprintf(stderr, "%s on %s (%s, %d threads): out of memory, skipped\n", w->name, k->name, k->api, t);
+                    skipped++;
+                    continue;
+                }
+                double per_unit = (double)o.bits / (double)units;
+                printf("%-10s %-17s %-8s %3d %9.3f %10.4g %10.4g %12.6f %10.6f\n", w->name, k->name, k->api, t, o.seconds,
+                       (double)units / o.seconds, per_unit, o.result, w->expected);
+                fprintf(out,
+                        "%s\n    {\"workload\": \"%s\", \"unit\": \"%s\", \"generator\": \"%s\", \"api\": \"%s\", "
+                        "\"width\": %d, \"threads\": %d, \"units\": %ld, \"seconds\": %.6f, \"bits\": %llu, "
+                        "\"bits_per_unit\": %.3f, \"units_per_second\": %.1f, \"result\": %.9g, \"expected\": %.9g}",
+                        first ? "" : ",", w->name, w->unit, k->name, k->api, k->width, t, units, o.seconds,
+                        (unsigned long long)o.bits, per_unit, (double)units / o.seconds, o.result, w->expected);
+                first = 0;
+                fflush(stdout);
+            }
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    fclose(out);
+    printf("\nwrote %s\n", json);
+    if (skipped) {
+        fprintf(stderr, "%d runs skipped\n", skipped);
+        return 1;
+    }
+    return 0;
+}
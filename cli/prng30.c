@@ -0,0 +1,335 @@
+#include "../include/prng30.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//  Command-line generator: writes values as text, one per line.
+//
+//  Values are cut from the prng30_fill byte stream, so every format prints
+//  exactly what the matching library calls return for the same seed:
+//  u64 and hex are prng30_generate(st, 64), u32 is prng30_generate(st, 32)
+//  and double is prng30_generate_double. Numbers are formatted by hand
+//  (digit-pair tables, no printf) into a 1 MiB buffer that goes out in a
+//  single write, which keeps text output close to raw generation speed.
+
+//  Usage:
+//    ./prng30 [--seed N] [--width W] [--count N] [--format F] [--hybrid]
+
+//    --seed N    : def: time-based
+//    --width W   : automaton width (def: 64)
+//    --count N   : values to write, 0 for no limit (def: 10)
+//    --format F  : u64 (def), u32, hex (16 digits) or double
+//    --hybrid    : use hybrid mode (prng30_init_hybrid)
+
+//  Doubles are printed with the fewest digits that read back as the same
+//  value, e.g. 0.5 rather than 0.50000000000000000.
+
+//  Example:
+//    ./prng30 --seed 42 --count 5
+//    ./prng30 --seed 42 --count 100000000 --format double > values.txt
+
+#define BATCH 8192          // values generated per prng30_fill call
+#define OUT_BYTES (1 << 20) // output buffer, flushed with one write
+#define MAX_LINE 40         // longest line of any format
+
+enum { FMT_U64, FMT_U32, FMT_HEX, FMT_DOUBLE };
+
+static char digits2[200]; // "00", "01", ..., "99"
+static char hex2[512];    // "00", "01", ..., "ff"
+
+static void init_tables(void) {
+    for (int i = 0; i < 100; i++) {
+        digits2[2 * i]     = (char)('0' + i / 10);
+        digits2[2 * i + 1] = (char)('0' + i % 10);
+    }
+    for (int i = 0; i < 256; i++) {
+        hex2[2 * i]     = "0123456789abcdef"[i >> 4];
+        hex2[2 * i + 1] = "0123456789abcdef"[i & 15];
+    }
+}
+
+static uint64_t load_be(const uint8_t *p, int nbytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < nbytes; i++)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+// Exactly n decimal digits of v, zero-padded, written backwards two at a
+// time.
+static char *put_fixed(char *p, uint64_t v, int n) {
+    char *q = p + n;
+    while (q - p >= 2) {
+        q -= 2;
+        memcpy(q, digits2 + 2 * (v % 100), 2);
+        v /= 100;
+    }
+    if (q > p)
+        *--q = (char)('0' + v % 10);
+    return p + n;
+}
+
+static int decimal_len(uint64_t v) {
+    int n = 1;
+    while (v >= 10) {
+        v /= 10;
+        n++;
+    }
+    return n;
+}
+
+static char *put_u64(char *p, uint64_t v) {
+    return put_fixed(p, v, decimal_len(v));
+}
+
+static char *put_hex(char *p, const uint8_t *bytes) {
+    for (int i = 0; i < 8; i++) {
+        memcpy(p, hex2 + 2 * bytes[i], 2);
+        p += 2;
+    }
+    return p;
+}
+
+// The fewest decimal places that strtod reads back as d, 0 < d < 1, found
+// with printf. For each digit count the nearest decimal is tried, then the
+// one above it: where d is a power of two its interval is lopsided and
+// the nearest can miss while the next one up hits.
+static char *put_double_slow(char *p, double d) {
+    char tmp[40];
+    for (int prec = 1; prec <= 17; prec++) {
+        snprintf(tmp, sizeof(tmp), "%.*e", prec - 1, d);
+        uint64_t digits = 0;
+        char    *s      = tmp;
+        for (; *s != 'e'; s++)
+            if (*s != '.')
+                digits = digits * 10 + (uint64_t)(*s - '0');
+        int places = prec - 1 - atoi(s + 1);
+
+        for (uint64_t c = digits; c <= digits + 1; c++) {
+            snprintf(tmp, sizeof(tmp), "%llue-%d", (unsigned long long)c, places);
+            if (strtod(tmp, NULL) == d || prec == 17) {
+                *p++ = '0';
+                *p++ = '.';
+                return put_fixed(p, c, places);
+            }
+        }
+    }
+    return p;
+}
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 u128;
+
+// The double k / 2^53, 0 < k < 2^53, in the fewest decimal places that
+// read back as the same double.
+//
+// With the value written m * 2^q (m a 53-bit mantissa), every decimal
+// within half an ulp of it, boundaries included when m is even, rounds
+// back to it. Scaled by 10^n and 2^t, that interval and the value itself
+// are the integers below, exact in 128 bits while n <= 27. Dlo..Dhi are
+// then the n-place decimals that round-trip; the shortest is the largest
+// power-of-ten multiple among them, and of those the one nearest the
+// value is printed. Values under about 1e-10 need more places than that
+// and take the printf path.
+static char *put_double(char *p, uint64_t k) {
+    static const uint64_t pow5[28] = {
+        1ULL, 5ULL, 25ULL, 125ULL, 625ULL, 3125ULL, 15625ULL, 78125ULL, 390625ULL, 1953125ULL,
+        9765625ULL, 48828125ULL, 244140625ULL, 1220703125ULL, 6103515625ULL, 30517578125ULL,
+        152587890625ULL, 762939453125ULL, 3814697265625ULL, 19073486328125ULL, 95367431640625ULL,
+        476837158203125ULL, 2384185791015625ULL, 11920928955078125ULL, 59604644775390625ULL,
+        298023223876953125ULL, 1490116119384765625ULL, 7450580596923828125ULL,
+    };
+
+    int      shift = __builtin_clzll(k) - 11;
+    uint64_t m     = k << shift;
+    int      q     = -53 - shift;
+    int      even  = (m & 1) == 0;
+
+    // 17 significant digits always suffice; start there, past the leading
+    // zeros (estimated from the exponent; a low guess just costs a retry).
+    int  n = 17 + (shift * 77 >> 8);
+    int  t;
+    u128 mid, dlo, dhi;
+    for (;; n++) {
+        if (n > 27)
+            return put_double_slow(p, (double)k / (double)(1ULL << 53));
+        t       = 2 - q - n;
+        mid     = (u128)(4 * m) * pow5[n];
+        u128 lo = (u128)(4 * m - (m == 1ULL << 52 ? 1 : 2)) * pow5[n];
+        u128 hi = (u128)(4 * m + 2) * pow5[n];
+
+        dlo = (lo + ((u128)1 << t) - 1) >> t;
+        dhi = hi >> t;
+        if (!even && (dlo << t) == lo)
+            dlo++;
+        if (!even && (dhi << t) == hi)
+            dhi--;
+        if (dlo <= dhi)
+            break;
+    }
+
+    u128 pw = 1;
+    while (n > 1 && dhi / (pw * 10) * (pw * 10) >= dlo) {
+        pw *= 10;
+        n--;
+    }
+
+    // Round the value to a multiple of pw, half to even, then keep it
+    // inside the interval.
+    u128 d    = (mid >> t) / pw;
+    u128 rem  = mid - ((d * pw) << t);
+    u128 half = pw << t;
+    if (2 * rem > half || (2 * rem == half && (d & 1)))
+        d++;
+    u128 dmin = (dlo + pw - 1) / pw, dmax = dhi / pw;
+    d         = (d < dmin) ? dmin : (d > dmax) ? dmax : d;
+
+    // At most 17 significant digits, so d fits in 64 bits.
+    *p++ = '0';
+    *p++ = '.';
+    return put_fixed(p, (uint64_t)d, n);
+}
+#else
+static char *put_double(char *p, uint64_t k) {
+    return put_double_slow(p, (double)k / (double)(1ULL << 53));
+}
+#endif
+
+// Append the text of nvals values, taken from raw, to out.
+static char *format_batch(char *out, const uint8_t *raw, size_t nvals, int format) {
+    for (size_t i = 0; i < nvals; i++) {
+        switch (format) {
+        case FMT_U64:
+            out = put_u64(out, load_be(raw + 8 * i, 8));
+            break;
+        case FMT_U32:
+            out = put_u64(out, load_be(raw + 4 * i, 4));
+            break;
+        case FMT_HEX:
+            out = put_hex(out, raw + 8 * i);
+            break;
+        case FMT_DOUBLE: {
+            // Value i is bits [53i, 53i + 53) of the stream, MSB first.
+            size_t   bit = 53 * i;
+            uint64_t k   = (load_be(raw + bit / 8, 8) << (bit % 8)) >> 11;
+            if (k == 0)
+                *out++ = '0';
+            else
+                out = put_double(out, k);
+            break;
+        }
+        }
+        *out++ = '\n';
+    }
+    return out;
+}
+
+static size_t raw_bytes(size_t nvals, int format) {
+    switch (format) {
+    case FMT_U32:
+        return 4 * nvals;
+    case FMT_DOUBLE:
+        return (53 * nvals + 7) / 8;
+    default:
+        return 8 * nvals;
+    }
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: prng30 [--seed N] [--width W] [--count N] [--format u64|u32|hex|double] [--hybrid]\n");
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t    seed   = (uint64_t)time(NULL);
+    uint64_t    count  = 10;
+    int         width  = 64;
+    int         hybrid = 0;
+    const char *fmt    = "u64";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = (uint64_t)strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc)
+            width = (int)strtol(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+            fmt = argv[++i];
+        else if (strcmp(argv[i], "--hybrid") == 0)
+            hybrid = 1;
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    int format;
+    if (strcmp(fmt, "u64") == 0)
+        format = FMT_U64;
+    else if (strcmp(fmt, "u32") == 0)
+        format = FMT_U32;
+    else if (strcmp(fmt, "hex") == 0)
+        format = FMT_HEX;
+    else if (strcmp(fmt, "double") == 0)
+        format = FMT_DOUBLE;
+    else {
+        usage();
+        return 1;
+    }
+
+    if (width < PRNG30_MIN_WIDTH || width > PRNG30_MAX_WIDTH) {
+        fprintf(stderr, "width must be in [%d, %d]\n", PRNG30_MIN_WIDTH, PRNG30_MAX_WIDTH);
+        return 1;
+    }
+
+    prng30_state st;
+    prng30_err   err = hybrid ? prng30_init_hybrid(&st, seed, width) : prng30_init(&st, seed, width);
+    if (err != PRNG30_OK) {
+        fprintf(stderr, "prng30_init failed: %d\n", err);
+        return 1;
+    }
+
+    // The 8 spare bytes let the double path load a whole word at any bit.
+    uint8_t *raw = calloc(8 * BATCH + 8, 1);
+    char    *out = malloc(OUT_BYTES);
+    if (!raw || !out) {
+        fprintf(stderr, "out of memory\n");
+        prng30_free(&st);
+        free(raw);
+        free(out);
+        return 1;
+    }
+
+    init_tables();
+    // Unbuffered, so each fwrite of the full buffer is one write call.
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    int      ret  = 0;
+    char    *end  = out;
+    uint64_t left = count;
+    while (count == 0 || left > 0) {
+        size_t nvals = (count == 0 || left > BATCH) ? BATCH : (size_t)left;
+        prng30_fill(&st, raw, raw_bytes(nvals, format));
+        end = format_batch(end, raw, nvals, format);
+        if (count != 0)
+            left -= nvals;
+
+        int last = count != 0 && left == 0;
+        if (last || (size_t)(out + OUT_BYTES - end) < BATCH * MAX_LINE) {
+            size_t len = (size_t)(end - out);
+            if (fwrite(out, 1, len, stdout) != len) {
+                ret = 1;
+                break;
+            }
+            end = out;
+        }
+    }
+
+    prng30_free(&st);
+    free(raw);
+    free(out);
+    return ret;
+}
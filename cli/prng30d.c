@@ -0,0 +1,78 @@
+#include "../include/prng30_serve.h"
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//  Local random-byte server: keeps one warm generator per width and
+//  serves bytes over a Unix domain socket to prng30_client_* callers.
+//  Runs in the foreground until SIGINT or SIGTERM, then removes the
+//  socket file.
+
+//  Usage:
+//    ./prng30d [--socket PATH] [--seed N] [--reserve BYTES] [--widths N]
+
+//    --socket PATH   : def: /tmp/prng30.sock
+//    --seed N        : def: time-based
+//    --reserve BYTES : pre-generated bytes kept per width (def: 262144)
+//    --widths N      : distinct widths served (def: 16)
+
+//  Example:
+//    ./prng30d --socket /run/prng30.sock &
+//    ./serve_load /run/prng30.sock 64 2000 4096
+
+static prng30_server *g_server;
+
+static void on_signal(int sig) {
+    (void)sig;
+    prng30_server_stop(g_server);
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: prng30d [--socket PATH] [--seed N] [--reserve BYTES] [--widths N]\n");
+}
+
+int main(int argc, char *argv[]) {
+    prng30_server_config cfg;
+    const char          *path = PRNG30_SERVE_DEFAULT_PATH;
+
+    prng30_server_default_config(&cfg);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc)
+            path = argv[++i];
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            cfg.seed = (uint64_t)strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--reserve") == 0 && i + 1 < argc)
+            cfg.reserve = (size_t)strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--widths") == 0 && i + 1 < argc)
+            cfg.max_widths = atoi(argv[++i]);
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    prng30_err err = prng30_server_create(&g_server, path, &cfg);
+    if (err != PRNG30_OK) {
+        fprintf(stderr, "cannot listen on %s: %d\n", path, err);
+        return 1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    fprintf(stderr, "prng30d: listening on %s\n", path);
+    err = prng30_server_run(g_server);
+    prng30_server_destroy(g_server);
+    if (err != PRNG30_OK) {
+        fprintf(stderr, "prng30d: server failed: %d\n", err);
+        return 1;
+    }
+    return 0;
+}
@@ -6,6 +6,7 @@
  * NOT cryptographically secure.
  */
 
+#include <stddef.h>
 #include <stdint.h>
 
 typedef enum {
@@ -13,15 +14,41 @@ typedef enum {
     PRNG30_ERR_ALLOC    = -1,
     PRNG30_ERR_BADWIDTH = -2,
     PRNG30_ERR_NULL     = -3,
+    PRNG30_ERR_THREAD   = -4,
+    PRNG30_ERR_IO       = -5,
+    PRNG30_ERR_FORMAT   = -6,
+    PRNG30_ERR_MISMATCH = -7,
+    PRNG30_ERR_RANGE    = -8,
+    PRNG30_ERR_MODE     = -9,
 } prng30_err;
 
+typedef enum {
+    PRNG30_MODE_PLAIN  = 0, /* Rule 30 alone (prng30_init) */
+    PRNG30_MODE_HYBRID = 1, /* Rule 30 combined with a linear CA (prng30_init_hybrid) */
+} prng30_mode;
+
+/* Output bits per Rule 30 reseed in hybrid mode. */
+#define PRNG30_HYBRID_BLOCK 65536
+
 #define PRNG30_MIN_WIDTH 32
 #define PRNG30_MAX_WIDTH 4096
 
+/* Number of 64-bit words in a bit-packed row of `width` cells. */
+#define PRNG30_WORDS(width) (((width) + 63) / 64)
+
+/*
+ * Rows are bit-packed: cell i is bit (i % 64) of row[i / 64]. Bits past
+ * the last cell in the final word are always zero, so two rows of the
+ * same width can be compared with memcmp.
+ */
 typedef struct {
-    int      width;
-    uint8_t *row;
-    uint8_t *next_row;
+    int       width;
+    int       nwords;
+    uint64_t *row;
+    uint64_t *next_row;
+    int       mode; /* prng30_mode */
+    uint64_t  lin;  /* hybrid: linear CA cells */
+    uint64_t  pos;  /* hybrid: output bits produced */
 } prng30_state;
 
 /*
@@ -33,12 +60,49 @@ typedef struct {
  */
 prng30_err prng30_init(prng30_state *st, uint64_t seed, int width);
 
+/*
+ * prng30_init_hybrid — initialise in hybrid mode, which can jump ahead.
+ *
+ * A 64-cell null-boundary Rule 90/150 automaton runs beside the Rule 30
+ * row, and each output bit is the Rule 30 tap bit XOR one linear cell.
+ * The linear part is chosen to have a primitive characteristic
+ * polynomial, so it cycles through all 2^64 - 1 nonzero states, and being
+ * linear it can be advanced n steps in O(log n). Rule 30 cannot, so it is
+ * reseeded from the linear state every PRNG30_HYBRID_BLOCK output bits;
+ * a jump then lands on a block start and walks the remainder.
+ *
+ * generate, fill and prng30_jump honour the mode. prng30_step and
+ * prng30_cell act on the Rule 30 row only. Same arguments and errors as
+ * prng30_init; the stream differs from plain mode.
+ */
+prng30_err prng30_init_hybrid(prng30_state *st, uint64_t seed, int width);
+
+/*
+ * prng30_jump — skip the next n output bits, as if generated and
+ * discarded. Costs O(log n) for the linear part plus at most one reseed
+ * and PRNG30_HYBRID_BLOCK Rule 30 steps, whatever n is.
+ * Returns PRNG30_OK, PRNG30_ERR_NULL, or PRNG30_ERR_MODE for a plain-mode
+ * state, which has no jump-ahead.
+ */
+prng30_err prng30_jump(prng30_state *st, uint64_t n);
+
 /* Release resources. Safe on a zeroed or already-freed state. */
 void prng30_free(prng30_state *st);
 
 /* Advance by one generation. Exposed for direct CA experiments. */
 void prng30_step(prng30_state *st);
 
+/* Value (0 or 1) of cell i of the current generation, i in [0, width). */
+int prng30_cell(const prng30_state *st, int i);
+
+/*
+ * prng30_step_packed — advance a bare bit-packed row by one generation.
+ *   dst, src : PRNG30_WORDS(width) words each; must not overlap
+ *   width    : cell count, any value >= 1 (not limited to PRNG30_MAX_WIDTH)
+ * Periodic boundaries, identical to prng30_step.
+ */
+void prng30_step_packed(uint64_t *dst, const uint64_t *src, int width);
+
 /*
  * prng30_generate — return a random integer.
  *   nbits : bits to generate [1 .. 64]; silently clamped if outside range
@@ -48,4 +112,63 @@ uint64_t prng30_generate(prng30_state *st, int nbits);
 /* Uniform double in [0, 1) using 53 bits of entropy. */
 double prng30_generate_double(prng30_state *st);
 
+/*
+ * prng30_fill — write len random bytes to buf.
+ * Byte i equals the i-th successive prng30_generate(st, 8), so the
+ * stream is the same however the output is split across calls.
+ */
+void prng30_fill(prng30_state *st, void *buf, size_t len);
+
+/*
+ * Shuffling and sampling. Each random index is drawn with only the bits
+ * its range needs (rejection sampling), so an index below 2^k costs about
+ * k CA steps rather than 64.
+ */
+
+/* Unbiased integer in [0, bound); 0 if bound <= 1. */
+uint64_t prng30_uniform(prng30_state *st, uint64_t bound);
+
+/*
+ * prng30_shuffle — Fisher-Yates shuffle of n elements of `size` bytes.
+ * Indices are generated in batches ahead of the swaps and their target
+ * slots prefetched, so large arrays are limited by memory bandwidth.
+ */
+void prng30_shuffle(prng30_state *st, void *base, size_t n, size_t size);
+
+/*
+ * prng30_sample — k distinct integers from [0, n) by Floyd's algorithm,
+ * O(k) time and memory regardless of n. Every k-subset is equally likely;
+ * the order within out is not random (shuffle it if that matters).
+ * Returns PRNG30_OK, PRNG30_ERR_NULL, PRNG30_ERR_RANGE (k > n) or
+ * PRNG30_ERR_ALLOC.
+ */
+prng30_err prng30_sample(prng30_state *st, uint64_t n, size_t k, uint64_t *out);
+
+/*
+ * prng30_reservoir — copy a uniform random k-subset of the n elements
+ * (`size` bytes each) of src into dst, by reservoir sampling with
+ * geometric skips: only O(k log(n/k)) elements are read.
+ * Returns PRNG30_OK, PRNG30_ERR_NULL or PRNG30_ERR_RANGE (k > n).
+ */
+prng30_err prng30_reservoir(prng30_state *st, const void *src, size_t n, size_t size, void *dst, size_t k);
+
+/*
+ * Counter-based blocks. Block `index` of the logical stream (seed, width)
+ * is the output of a fresh generator initialised with
+ * prng30_block_seed(seed, index), so any block can be produced on its own
+ * at a cost that does not depend on index: one prng30_init-style warmup
+ * (width/2 steps) plus the bytes requested.
+ */
+
+/* Seed of block `index`: two rounds of splitmix64 over (seed, index). */
+uint64_t prng30_block_seed(uint64_t seed, uint64_t index);
+
+/*
+ * prng30_block — write the first len bytes of block `index` to buf.
+ * Equivalent to prng30_init(&st, prng30_block_seed(seed, index), width)
+ * followed by prng30_fill(&st, buf, len), without allocating.
+ * Returns PRNG30_OK, PRNG30_ERR_NULL or PRNG30_ERR_BADWIDTH.
+ */
+prng30_err prng30_block(uint64_t seed, int width, uint64_t index, void *buf, size_t len);
+
 #endif /* PRNG30_H */
@@ -0,0 +1,60 @@
+#ifndef PRNG30_ASYNC_H
+#define PRNG30_ASYNC_H
+
+/*
+ * prng30_async — background-refilled byte stream.
+ *
+ * A worker thread keeps a single-producer/single-consumer ring of
+ * pre-generated bytes topped up, so prng30_async_read is normally just a
+ * copy out of the ring. The bytes returned are exactly those prng30_fill
+ * would have produced from the same state.
+ *
+ * One thread may read from a given prng30_async at a time, and
+ * prng30_async_destroy must not overlap a read.
+ */
+
+#include "prng30.h"
+
+#include <stddef.h>
+
+typedef enum {
+    PRNG30_ASYNC_BLOCK    = 0, /* wait for the worker when the ring is empty */
+    PRNG30_ASYNC_FALLBACK = 1, /* generate inline on the caller's thread instead */
+} prng30_async_policy;
+
+typedef struct {
+    size_t              capacity;   /* ring size in bytes, rounded up to a power of two (at most SIZE_MAX / 2 + 1) */
+    size_t              low_water;  /* worker wakes when fewer bytes than this are buffered */
+    size_t              high_water; /* and then refills up to this many */
+    prng30_async_policy policy;
+} prng30_async_config;
+
+typedef struct prng30_async prng30_async;
+
+/* Defaults: 1 MiB ring, refill below 256 KiB, block when empty. */
+void prng30_async_default_config(prng30_async_config *cfg);
+
+/*
+ * prng30_async_create — start a worker generating from *st.
+ *   st  : initialised state; ownership moves to the generator and *st is
+ *         zeroed, so the caller's prng30_free(st) remains safe
+ *   cfg : NULL for defaults
+ * Returns PRNG30_OK, PRNG30_ERR_NULL, PRNG30_ERR_RANGE (capacity too large
+ * to round up), PRNG30_ERR_ALLOC or PRNG30_ERR_THREAD.
+ * On failure *st is left untouched and *out is NULL.
+ */
+prng30_err prng30_async_create(prng30_async **out, prng30_state *st, const prng30_async_config *cfg);
+
+/*
+ * Stop the worker, wait for it to exit and release everything. Safe on
+ * NULL. Must not be called while a prng30_async_read is in progress.
+ */
+void prng30_async_destroy(prng30_async *a);
+
+/* Copy the next n bytes of the stream into buf; always all n of them. */
+void prng30_async_read(prng30_async *a, void *buf, size_t n);
+
+/* Bytes currently buffered; a hint, as the worker may add more at any time. */
+size_t prng30_async_available(const prng30_async *a);
+
+#endif /* PRNG30_ASYNC_H */
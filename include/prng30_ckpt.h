@@ -0,0 +1,67 @@
+#ifndef PRNG30_CKPT_H
+#define PRNG30_CKPT_H
+
+/*
+ * prng30_ckpt — indexed checkpoint log for seeking within one long stream.
+ *
+ * The log stores a bit-packed snapshot of the automaton every `interval`
+ * generations of the stream (seed, width). Since the generator steps once
+ * per output bit, checkpoint i holds the state just before output bit
+ * i * interval. Seeking to bit N loads checkpoint N / interval and steps
+ * N % interval times; a smaller interval means faster seeks and a larger
+ * file (one row, 8 * ceil(width / 64) bytes, plus 8 bytes per checkpoint).
+ *
+ * File layout, all integers little-endian:
+ *   header  : "PRNG30CK", u32 version, u32 width, u64 seed, u64 interval,
+ *             u64 count
+ *   records : count fixed-size records of u64 bit offset + row words,
+ *             so record i is found by arithmetic alone
+ */
+
+#include "prng30.h"
+
+#include <stdio.h>
+
+typedef struct {
+    FILE    *f;
+    int      width;
+    uint64_t seed;
+    uint64_t interval;
+    uint64_t count;
+} prng30_ckpt;
+
+/*
+ * prng30_ckpt_create — generate the stream and write a log covering
+ * output bits [0, bits). Overwrites path.
+ * Returns PRNG30_OK, PRNG30_ERR_NULL, PRNG30_ERR_RANGE (interval 0),
+ * PRNG30_ERR_BADWIDTH, PRNG30_ERR_ALLOC or PRNG30_ERR_IO.
+ */
+prng30_err prng30_ckpt_create(const char *path, uint64_t seed, int width, uint64_t interval, uint64_t bits);
+
+/*
+ * prng30_ckpt_open — open an existing log for reading.
+ * Returns PRNG30_OK, PRNG30_ERR_NULL, PRNG30_ERR_IO or PRNG30_ERR_FORMAT.
+ * On failure *log is zeroed and prng30_ckpt_close is safe to call.
+ */
+prng30_err prng30_ckpt_open(prng30_ckpt *log, const char *path);
+
+/* Close the file. Safe on a zeroed or already-closed log. */
+void prng30_ckpt_close(prng30_ckpt *log);
+
+/*
+ * prng30_ckpt_seek — initialise *st so that its next output bit is bit
+ * `bit` of the stream. Costs one record read plus at most `interval`
+ * steps when bit lies inside the logged range, more beyond it.
+ * On success *st must be released with prng30_free.
+ */
+prng30_err prng30_ckpt_seek(prng30_ckpt *log, prng30_state *st, uint64_t bit);
+
+/*
+ * prng30_ckpt_verify — check checkpoint `index` by regenerating it from
+ * checkpoint index - 1 (or from prng30_init for index 0). Verifying every
+ * index in order checks the whole log against the stream.
+ * Returns PRNG30_OK, PRNG30_ERR_MISMATCH, or an I/O or format error.
+ */
+prng30_err prng30_ckpt_verify(prng30_ckpt *log, uint64_t index);
+
+#endif /* PRNG30_CKPT_H */
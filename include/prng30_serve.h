@@ -0,0 +1,90 @@
+#ifndef PRNG30_SERVE_H
+#define PRNG30_SERVE_H
+
+/*
+ * prng30_serve — random bytes for local processes over a Unix socket.
+ *
+ * A server keeps one warm generator per width and answers requests for
+ * bytes, so a short-lived process gets its first bytes for the cost of a
+ * connect and one round trip instead of a prng30_init warmup. Each
+ * generator keeps a reserve of pre-generated bytes, topped up whenever
+ * the server is idle, so most requests are a copy and a write.
+ *
+ * The server is single-threaded and driven by epoll (Linux). Each wakeup
+ * first reads every ready request, then serves them all, then writes the
+ * replies.
+ *
+ * Requests are 8 bytes, u32 width then u32 length in host byte order, and
+ * the reply is that many bytes. A request for a bad width or for more
+ * than PRNG30_SERVE_MAX_REQUEST bytes closes the connection.
+ *
+ * All clients of one width share one stream, so what a client receives
+ * is not reproducible from a seed. Use prng30_init where it must be.
+ */
+
+#include "prng30.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PRNG30_SERVE_DEFAULT_PATH "/tmp/prng30.sock"
+#define PRNG30_SERVE_MAX_REQUEST (1u << 20)
+
+typedef struct {
+    uint64_t seed;       /* the generator for width w is prng30_init(seed, w) */
+    size_t   reserve;    /* bytes kept pre-generated per width */
+    int      max_widths; /* distinct widths served; requests for more are refused */
+} prng30_server_config;
+
+typedef struct prng30_server prng30_server;
+typedef struct prng30_client prng30_client;
+
+/* Defaults: time-based seed, 256 KiB reserve, 16 widths. */
+void prng30_server_default_config(prng30_server_config *cfg);
+
+/*
+ * prng30_server_create — bind and listen on path (NULL for the default),
+ * replacing a socket file left there by a server that has exited. cfg
+ * NULL for defaults.
+ * Returns PRNG30_OK, PRNG30_ERR_RANGE (reserve over SIZE_MAX / 2 + 1),
+ * PRNG30_ERR_ALLOC or PRNG30_ERR_IO, including when a live server is
+ * listening on path or something other than a socket exists there; either
+ * is left alone.
+ */
+prng30_err prng30_server_create(prng30_server **out, const char *path, const prng30_server_config *cfg);
+
+/* Serve until prng30_server_stop. Returns PRNG30_OK or PRNG30_ERR_IO. */
+prng30_err prng30_server_run(prng30_server *s);
+
+/* Make prng30_server_run return. Safe from any thread and from a signal handler. */
+void prng30_server_stop(prng30_server *s);
+
+/* Close every connection, remove the socket file and free. Safe on NULL. */
+void prng30_server_destroy(prng30_server *s);
+
+/*
+ * prng30_client_connect — connect to the server at path (NULL for the
+ * default) for bytes from its width-cell generator.
+ * Returns PRNG30_OK, PRNG30_ERR_NULL, PRNG30_ERR_BADWIDTH, PRNG30_ERR_ALLOC
+ * or PRNG30_ERR_IO (no server listening).
+ */
+prng30_err prng30_client_connect(prng30_client **out, const char *path, int width);
+
+/* Close the connection and free. Safe on NULL. */
+void prng30_client_close(prng30_client *c);
+
+/*
+ * As prng30_fill and prng30_generate, with bytes from the server. The two
+ * may be mixed: as locally, each call continues the bit stream where the
+ * last one stopped. Small reads are served from a local buffer; reads
+ * larger than it go to the server directly. Once the connection fails,
+ * fill returns PRNG30_ERR_IO and generate returns 0;
+ * prng30_client_status reports which.
+ */
+prng30_err prng30_client_fill(prng30_client *c, void *buf, size_t len);
+uint64_t   prng30_client_generate(prng30_client *c, int nbits);
+
+/* PRNG30_OK, or PRNG30_ERR_IO once the connection has failed. */
+prng30_err prng30_client_status(const prng30_client *c);
+
+#endif /* PRNG30_SERVE_H */
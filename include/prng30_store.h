@@ -0,0 +1,94 @@
+#ifndef PRNG30_STORE_H
+#define PRNG30_STORE_H
+
+/*
+ * prng30_store — file-backed array of generator states.
+ *
+ * The file holds `count` fixed-size slots, each the bit-packed row of one
+ * width-cell automaton, and is mapped into memory whole. Generation works
+ * directly on the mapped slot, so opening a store of millions of states
+ * costs one mmap: nothing is allocated or deserialised per state, and
+ * pages are read in as slots are first used.
+ *
+ * Slot strides are powers of two up to 64 bytes and multiples of 64 above
+ * that, so small slots never straddle a cache line. Writes mark the pages
+ * they touch in a dirty bitmap; prng30_store_flush writes back dirty pages,
+ * optionally a bounded number per call so flushing can be spread out.
+ *
+ * A slot generates exactly the stream of a prng30_state with the same
+ * seed and width, and states move between the two with load and save.
+ *
+ * File layout: a 64-byte header ("PRNG30ST", u32 version, u32 width,
+ * u64 count, u64 stride, u64 byte-order tag) followed by the slots. Slots
+ * hold rows in host byte order; a store opened on a host of the other
+ * byte order is rejected with PRNG30_ERR_FORMAT.
+ *
+ * Different ids may be used from different threads at the same time.
+ * flush and close must not run concurrently with anything else.
+ */
+
+#include "prng30.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    int       fd;
+    uint8_t  *base;   /* whole mapping, header included */
+    size_t    size;
+    int       width;
+    int       nwords;
+    uint64_t  count;
+    size_t    stride; /* bytes per slot */
+    size_t    page;
+    size_t    npages;
+    uint64_t *dirty;  /* one bit per page of the mapping */
+} prng30_store;
+
+/*
+ * prng30_store_create — create (or overwrite) a store of `count` slots and
+ * map it. Slots start all-zero: seed each before generating from it.
+ * Returns PRNG30_OK, PRNG30_ERR_NULL, PRNG30_ERR_BADWIDTH, PRNG30_ERR_RANGE
+ * (count is 0 or too large to map), PRNG30_ERR_ALLOC or PRNG30_ERR_IO.
+ * On failure *s is zeroed and prng30_store_close is safe to call.
+ */
+prng30_err prng30_store_create(prng30_store *s, const char *path, int width, uint64_t count);
+
+/*
+ * prng30_store_open — map an existing store.
+ * Returns PRNG30_OK, PRNG30_ERR_NULL, PRNG30_ERR_IO, PRNG30_ERR_FORMAT or
+ * PRNG30_ERR_ALLOC. On failure *s is zeroed.
+ */
+prng30_err prng30_store_open(prng30_store *s, const char *path);
+
+/* Flush every dirty page and unmap. Safe on a zeroed or closed store. */
+void prng30_store_close(prng30_store *s);
+
+/* Initialise slot id as prng30_init(seed, width) would. */
+prng30_err prng30_store_seed(prng30_store *s, uint64_t id, uint64_t seed);
+
+/* As prng30_generate and prng30_fill, on slot id. id must be < count. */
+uint64_t prng30_store_generate(prng30_store *s, uint64_t id, int nbits);
+void     prng30_store_fill(prng30_store *s, uint64_t id, void *buf, size_t len);
+
+/*
+ * prng30_store_load — copy slot id into a new heap state, to be released
+ * with prng30_free. prng30_store_save copies a state back into slot id;
+ * its width must match the store's and it must be in plain mode.
+ * Return PRNG30_OK, PRNG30_ERR_NULL, PRNG30_ERR_RANGE (bad id),
+ * PRNG30_ERR_BADWIDTH, PRNG30_ERR_MODE or PRNG30_ERR_ALLOC.
+ */
+prng30_err prng30_store_load(const prng30_store *s, uint64_t id, prng30_state *st);
+prng30_err prng30_store_save(prng30_store *s, uint64_t id, const prng30_state *st);
+
+/*
+ * prng30_store_flush — write dirty pages back to the file and wait for
+ * them, at most max_pages of them (0: all). Adjacent dirty pages go out
+ * in one msync. Returns PRNG30_OK or PRNG30_ERR_IO.
+ */
+prng30_err prng30_store_flush(prng30_store *s, size_t max_pages);
+
+/* Pages written since they were last flushed. */
+size_t prng30_store_dirty_pages(const prng30_store *s);
+
+#endif /* PRNG30_STORE_H */
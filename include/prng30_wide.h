@@ -0,0 +1,83 @@
+#ifndef PRNG30_WIDE_H
+#define PRNG30_WIDE_H
+
+/*
+ * prng30_wide — one very wide automaton stepped by several threads.
+ *
+ * The bit-packed row is split into contiguous slices, one per thread.
+ * Each thread copies its slice plus a halo of `halo` cells on either side
+ * and advances that copy `halo` generations on its own: every generation
+ * the valid region shrinks by one cell at each end, so after `halo`
+ * generations exactly the slice is still exact. Threads therefore meet at
+ * a barrier once per `halo` generations instead of once per generation,
+ * and the extra work is the halo, a small fraction of a wide slice.
+ *
+ * Each thread first-touches the part of the row it owns and works through
+ * it in cache-sized tiles, so on NUMA machines a slice stays in its
+ * thread's local memory and the stepping stays in L1/L2.
+ *
+ * Seeding, warmup and output taps follow prng30_init and prng30_generate
+ * exactly, so for widths prng30_state supports the two produce the same
+ * stream.
+ *
+ * One thread may use a given prng30_wide at a time.
+ */
+
+#include "prng30.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PRNG30_WIDE_MAX_WIDTH (1 << 28)
+
+typedef struct {
+    int  threads; /* threads stepping the row, the caller included; 0: one per online CPU */
+    int  halo;    /* generations between synchronisations, = halo depth in cells */
+    long warmup;  /* generations run by create; -1: width / 2, as prng30_init */
+    int  pin;     /* Linux: bind helper thread i to the i-th CPU the process may
+                     use; the calling thread, which steps slice 0, is not moved */
+} prng30_wide_config;
+
+typedef struct prng30_wide prng30_wide;
+
+/* Defaults: one thread per CPU, halo 512, width / 2 warmup, no pinning. */
+void prng30_wide_default_config(prng30_wide_config *cfg);
+
+/*
+ * prng30_wide_create — seed a width-cell automaton and start its threads.
+ *   width : [PRNG30_MIN_WIDTH .. PRNG30_WIDE_MAX_WIDTH]
+ *   cfg   : NULL for defaults
+ * The default warmup is width / 2 generations, which dominates creation
+ * time for very wide rows; set cfg->warmup to trade diffusion for speed.
+ * Returns PRNG30_OK, PRNG30_ERR_NULL, PRNG30_ERR_BADWIDTH, PRNG30_ERR_ALLOC
+ * or PRNG30_ERR_THREAD. On failure *out is NULL.
+ */
+prng30_err prng30_wide_create(prng30_wide **out, uint64_t seed, int width, const prng30_wide_config *cfg);
+
+/* Stop the threads and release everything. Safe on NULL. */
+void prng30_wide_destroy(prng30_wide *w);
+
+/* Threads actually used; fewer than requested for narrow rows. */
+int prng30_wide_threads(const prng30_wide *w);
+
+/* Advance by `generations` generations, skipping their output bits. */
+void prng30_wide_step(prng30_wide *w, uint64_t generations);
+
+/* As prng30_generate. Output is computed `halo` bits at a time. */
+uint64_t prng30_wide_generate(prng30_wide *w, int nbits);
+
+/* As prng30_fill. */
+void prng30_wide_fill(prng30_wide *w, void *buf, size_t len);
+
+/*
+ * prng30_wide_row — copy the latest generation to dst, PRNG30_WORDS(width)
+ * words in prng30_state layout. Output is produced a batch at a time, so
+ * after generate or fill this generation may be ahead of the last bit
+ * returned; after prng30_wide_step or prng30_wide_set_row it is exact.
+ */
+void prng30_wide_row(const prng30_wide *w, uint64_t *dst);
+
+/* Replace the current generation with src and drop buffered output. */
+void prng30_wide_set_row(prng30_wide *w, const uint64_t *src);
+
+#endif /* PRNG30_WIDE_H */
@@ -0,0 +1,254 @@
+#include "../include/prng30_async.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Ring indices grow without bound and are reduced modulo the capacity on
+// access; head - tail is the number of buffered bytes. The worker is the
+// only writer of head and the reader the only writer of tail, so the ring
+// itself needs no lock, only acquire/release ordering on the indices.
+//
+// gen_lock guards the generator state. The worker holds it while it
+// generates a chunk and publishes head; a reader using the fallback policy
+// takes it before generating inline. Anything published before the reader
+// got the lock is older than the state's next output, so draining the ring
+// first keeps the stream identical to prng30_fill.
+//
+// wake_lock and the two condition variables are only used to put the
+// worker or a blocked reader to sleep; the data path never touches them.
+
+#define LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define LOAD_SC(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define STORE_SC(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+
+// Upper bound on one generate-and-publish step, which bounds how long an
+// inline fallback can wait for gen_lock.
+#define CHUNK 4096
+
+struct prng30_async {
+    uint8_t *ring;
+    size_t   mask;
+    size_t   low_water;
+    size_t   high_water;
+    int      policy;
+
+    // head and tail on separate cache lines so the two threads do not
+    // false-share them.
+    char   pad0[64];
+    size_t head; // written by the worker
+    char   pad1[64];
+    size_t tail; // written by the reader
+    char   pad2[64];
+
+    int worker_sleeping;
+    int reader_waiting;
+    int stop;
+
+    prng30_state    st;
+    pthread_mutex_t gen_lock;
+    pthread_mutex_t wake_lock;
+    pthread_cond_t  wake_worker;
+    pthread_cond_t  wake_reader;
+    pthread_t       thread;
+};
+
+void prng30_async_default_config(prng30_async_config *cfg) {
+    cfg->capacity   = 1u << 20;
+    cfg->low_water  = 1u << 18;
+    cfg->high_water = 1u << 20;
+    cfg->policy     = PRNG30_ASYNC_BLOCK;
+}
+
+static size_t level(const prng30_async *a) {
+    return LOAD(&a->head) - LOAD(&a->tail);
+}
+
+static void wake(prng30_async *a, pthread_cond_t *cond) {
+    pthread_mutex_lock(&a->wake_lock);
+    pthread_cond_broadcast(cond);
+    pthread_mutex_unlock(&a->wake_lock);
+}
+
+static void *worker(void *arg) {
+    prng30_async *a = arg;
+
+    for (;;) {
+        // Sleep until the level drops below the low watermark. The flag is
+        // set before re-checking the level so a reader that drains the ring
+        // concurrently is guaranteed to see it and signal.
+        pthread_mutex_lock(&a->wake_lock);
+        STORE_SC(&a->worker_sleeping, 1);
+        while (!LOAD_SC(&a->stop) && level(a) >= a->low_water)
+            pthread_cond_wait(&a->wake_worker, &a->wake_lock);
+        STORE_SC(&a->worker_sleeping, 0);
+        pthread_mutex_unlock(&a->wake_lock);
+
+        if (LOAD_SC(&a->stop))
+            break;
+
+        for (;;) {
+            pthread_mutex_lock(&a->gen_lock);
+            size_t head = a->head;
+            size_t have = head - LOAD(&a->tail);
+            if (have >= a->high_water || LOAD_SC(&a->stop)) {
+                pthread_mutex_unlock(&a->gen_lock);
+                break;
+            }
+            // One contiguous piece: up to the watermark, the end of the
+            // ring storage and CHUNK bytes, whichever is smallest.
+            size_t off  = head & a->mask;
+            size_t take = a->high_water - have;
+            if (take > a->mask + 1 - off)
+                take = a->mask + 1 - off;
+            if (take > CHUNK)
+                take = CHUNK;
+            prng30_fill(&a->st, a->ring + off, take);
+            STORE_SC(&a->head, head + take);
+            pthread_mutex_unlock(&a->gen_lock);
+
+            if (LOAD_SC(&a->reader_waiting))
+                wake(a, &a->wake_reader);
+        }
+    }
+
+    return NULL;
+}
+
+prng30_err prng30_async_create(prng30_async **out, prng30_state *st, const prng30_async_config *cfg) {
+    prng30_async_config def;
+
+    if (!out || !st || !st->row)
+        return PRNG30_ERR_NULL;
+    *out = NULL;
+
+    if (!cfg) {
+        prng30_async_default_config(&def);
+        cfg = &def;
+    }
+    // Past the largest power of two a size_t holds, rounding up would wrap.
+    if (cfg->capacity > ~(SIZE_MAX >> 1))
+        return PRNG30_ERR_RANGE;
+
+    prng30_async *a = calloc(1, sizeof(*a));
+    if (!a)
+        return PRNG30_ERR_ALLOC;
+
+    size_t cap = 64;
+    while (cap < cfg->capacity)
+        cap <<= 1;
+
+    a->ring       = malloc(cap);
+    a->mask       = cap - 1;
+    a->high_water = (cfg->high_water && cfg->high_water <= cap) ? cfg->high_water : cap;
+    a->low_water  = (cfg->low_water <= a->high_water) ? cfg->low_water : a->high_water;
+    a->policy     = cfg->policy;
+    if (a->low_water == 0)
+        a->low_water = 1;
+    if (!a->ring) {
+        free(a);
+        return PRNG30_ERR_ALLOC;
+    }
+
+    a->st        = *st;
+    int gen_lock = pthread_mutex_init(&a->gen_lock, NULL) == 0;
+    int wake     = pthread_mutex_init(&a->wake_lock, NULL) == 0;
+    int worker_c = pthread_cond_init(&a->wake_worker, NULL) == 0;
+    int reader_c = pthread_cond_init(&a->wake_reader, NULL) == 0;
+
+    if (!gen_lock || !wake || !worker_c || !reader_c || pthread_create(&a->thread, NULL, worker, a) != 0) {
+        if (gen_lock)
+            pthread_mutex_destroy(&a->gen_lock);
+        if (wake)
+            pthread_mutex_destroy(&a->wake_lock);
+        if (worker_c)
+            pthread_cond_destroy(&a->wake_worker);
+        if (reader_c)
+            pthread_cond_destroy(&a->wake_reader);
+        free(a->ring);
+        free(a);
+        return PRNG30_ERR_THREAD;
+    }
+
+    memset(st, 0, sizeof(*st));
+    *out = a;
+    return PRNG30_OK;
+}
+
+void prng30_async_destroy(prng30_async *a) {
+    if (!a)
+        return;
+
+    pthread_mutex_lock(&a->wake_lock);
+    STORE_SC(&a->stop, 1);
+    pthread_cond_broadcast(&a->wake_worker);
+    pthread_mutex_unlock(&a->wake_lock);
+    pthread_join(a->thread, NULL);
+
+    pthread_mutex_destroy(&a->gen_lock);
+    pthread_mutex_destroy(&a->wake_lock);
+    pthread_cond_destroy(&a->wake_worker);
+    pthread_cond_destroy(&a->wake_reader);
+    prng30_free(&a->st);
+    free(a->ring);
+    free(a);
+}
+
+size_t prng30_async_available(const prng30_async *a) {
+    return level(a);
+}
+
+// Copy up to n buffered bytes out of the ring; returns the count copied.
+static size_t drain(prng30_async *a, uint8_t *out, size_t n) {
+    size_t tail  = a->tail;
+    size_t avail = LOAD(&a->head) - tail;
+    if (n > avail)
+        n = avail;
+    if (n == 0)
+        return 0;
+
+    size_t off   = tail & a->mask;
+    size_t first = a->mask + 1 - off;
+    if (first > n)
+        first = n;
+    memcpy(out, a->ring + off, first);
+    memcpy(out + first, a->ring, n - first);
+    STORE_SC(&a->tail, tail + n);
+
+    if (avail - n < a->low_water && LOAD_SC(&a->worker_sleeping))
+        wake(a, &a->wake_worker);
+    return n;
+}
+
+void prng30_async_read(prng30_async *a, void *buf, size_t n) {
+    uint8_t *out = buf;
+
+    while (n > 0) {
+        size_t got = drain(a, out, n);
+        out += got;
+        n -= got;
+        if (n == 0)
+            break;
+
+        if (a->policy == PRNG30_ASYNC_FALLBACK) {
+            // Nothing can be published while we hold gen_lock, so once the
+            // ring is confirmed empty the state holds the next bytes.
+            pthread_mutex_lock(&a->gen_lock);
+            if (LOAD(&a->head) == a->tail) {
+                prng30_fill(&a->st, out, n);
+                n = 0;
+            }
+            pthread_mutex_unlock(&a->gen_lock);
+            continue;
+        }
+
+        pthread_mutex_lock(&a->wake_lock);
+        STORE_SC(&a->reader_waiting, 1);
+        if (LOAD_SC(&a->worker_sleeping))
+            pthread_cond_broadcast(&a->wake_worker);
+        while (LOAD_SC(&a->head) == a->tail)
+            pthread_cond_wait(&a->wake_reader, &a->wake_lock);
+        STORE_SC(&a->reader_waiting, 0);
+        pthread_mutex_unlock(&a->wake_lock);
+    }
+}
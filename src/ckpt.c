@@ -0,0 +1,233 @@
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L // fseeko, ftello
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64 // 64-bit off_t on 32-bit hosts
+#endif
+#endif
+
+#include "../include/prng30_ckpt.h"
+#include "prng30_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+// File offsets as 64-bit values; fseek/ftell take a long, which is 32 bits
+// on Windows and 32-bit hosts and caps logs at 2 GiB.
+#ifdef _WIN32
+typedef __int64 file_off;
+#define file_seek _fseeki64
+#define file_tell _ftelli64
+#else
+typedef off_t file_off;
+#define file_seek fseeko
+#define file_tell ftello
+#endif
+
+#define MAGIC "PRNG30CK"
+#define VERSION 1
+#define HEADER_BYTES 40
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+static size_t record_bytes(int width) {
+    return 8 + 8 * (size_t)PRNG30_WORDS(width);
+}
+
+static int write_record(FILE *f, uint64_t bit, const prng30_state *st, uint8_t *buf) {
+    put_u64(buf, bit);
+    for (int w = 0; w < st->nwords; w++)
+        put_u64(buf + 8 + 8 * w, st->row[w]);
+    return fwrite(buf, 1, record_bytes(st->width), f) == record_bytes(st->width);
+}
+
+// Read record `index` into st->row (already allocated for log->width).
+static prng30_err read_record(prng30_ckpt *log, uint64_t index, prng30_state *st, uint64_t *bit) {
+    uint8_t buf[8 + 8 * PRNG30_WORDS(PRNG30_MAX_WIDTH)];
+    size_t  n = record_bytes(log->width);
+
+    if (index >= log->count)
+        return PRNG30_ERR_FORMAT;
+    if (file_seek(log->f, (file_off)(HEADER_BYTES + index * n), SEEK_SET) != 0 || fread(buf, 1, n, log->f) != n)
+        return PRNG30_ERR_IO;
+
+    *bit = get_u64(buf);
+    for (int w = 0; w < st->nwords; w++)
+        st->row[w] = get_u64(buf + 8 + 8 * w);
+    return PRNG30_OK;
+}
+
+prng30_err prng30_ckpt_create(const char *path, uint64_t seed, int width, uint64_t interval, uint64_t bits) {
+    uint8_t      buf[8 + 8 * PRNG30_WORDS(PRNG30_MAX_WIDTH)];
+    prng30_state st;
+
+    if (!path)
+        return PRNG30_ERR_NULL;
+    if (interval == 0)
+        return PRNG30_ERR_RANGE;
+
+    prng30_err err = prng30_init(&st, seed, width);
+    if (err != PRNG30_OK)
+        return err;
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        prng30_free(&st);
+        return PRNG30_ERR_IO;
+    }
+
+    // Checkpoint i covers bits [i * interval, (i + 1) * interval).
+    uint64_t count = (bits + interval - 1) / interval;
+    if (count == 0)
+        count = 1;
+
+    memcpy(buf, MAGIC, 8);
+    put_u32(buf + 8, VERSION);
+    put_u32(buf + 12, (uint32_t)width);
+    put_u64(buf + 16, seed);
+    put_u64(buf + 24, interval);
+    put_u64(buf + 32, count);
+    int ok = fwrite(buf, 1, HEADER_BYTES, f) == HEADER_BYTES;
+
+    for (uint64_t i = 0; i < count && ok; i++) {
+        if (i > 0)
+            for (uint64_t s = 0; s < interval; s++)
+                prng30_step(&st);
+        ok = write_record(f, i * interval, &st, buf);
+    }
+
+    if (fclose(f) != 0)
+        ok = 0;
+    prng30_free(&st);
+    return ok ? PRNG30_OK : PRNG30_ERR_IO;
+}
+
+prng30_err prng30_ckpt_open(prng30_ckpt *log, const char *path) {
+    uint8_t hdr[HEADER_BYTES];
+
+    if (!log)
+        return PRNG30_ERR_NULL;
+    memset(log, 0, sizeof(*log));
+    if (!path)
+        return PRNG30_ERR_NULL;
+
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return PRNG30_ERR_IO;
+
+    if (fread(hdr, 1, HEADER_BYTES, f) != HEADER_BYTES || memcmp(hdr, MAGIC, 8) != 0 || get_u32(hdr + 8) != VERSION) {
+        fclose(f);
+        return PRNG30_ERR_FORMAT;
+    }
+
+    int      width    = (int)get_u32(hdr + 12);
+    uint64_t interval = get_u64(hdr + 24);
+    uint64_t count    = get_u64(hdr + 32);
+
+    // The file must hold every record the header promises.
+    file_off expect = -1;
+    if (width >= PRNG30_MIN_WIDTH && width <= PRNG30_MAX_WIDTH && interval > 0 && count > 0 &&
+        count <= (UINT64_MAX >> 1) / record_bytes(width))
+        expect = (file_off)(HEADER_BYTES + count * record_bytes(width));
+    if (expect < 0 || file_seek(f, 0, SEEK_END) != 0 || file_tell(f) < expect) {
+        fclose(f);
+        return PRNG30_ERR_FORMAT;
+    }
+
+    log->f        = f;
+    log->width    = width;
+    log->seed     = get_u64(hdr + 16);
+    log->interval = interval;
+    log->count    = count;
+    return PRNG30_OK;
+}
+
+void prng30_ckpt_close(prng30_ckpt *log) {
+    if (!log)
+        return;
+    if (log->f)
+        fclose(log->f);
+    memset(log, 0, sizeof(*log));
+}
+
+prng30_err prng30_ckpt_seek(prng30_ckpt *log, prng30_state *st, uint64_t bit) {
+    uint64_t at;
+
+    if (!log || !log->f || !st)
+        return PRNG30_ERR_NULL;
+
+    uint64_t index = bit / log->interval;
+    if (index >= log->count)
+        index = log->count - 1;
+
+    prng30_err err = prng30_alloc_state(st, log->width);
+    if (err != PRNG30_OK)
+        return err;
+
+    err = read_record(log, index, st, &at);
+    if (err == PRNG30_OK && at != index * log->interval)
+        err = PRNG30_ERR_FORMAT;
+    if (err != PRNG30_OK) {
+        prng30_free(st);
+        return err;
+    }
+
+    for (; at < bit; at++)
+        prng30_step(st);
+    return PRNG30_OK;
+}
+
+prng30_err prng30_ckpt_verify(prng30_ckpt *log, uint64_t index) {
+    prng30_state want, got;
+    uint64_t     at;
+    prng30_err   err;
+
+    if (!log || !log->f)
+        return PRNG30_ERR_NULL;
+    if (index >= log->count)
+        return PRNG30_ERR_FORMAT;
+
+    if (index == 0) {
+        err = prng30_init(&want, log->seed, log->width);
+    } else {
+        err = prng30_ckpt_seek(log, &want, (index - 1) * log->interval);
+        for (uint64_t s = 0; err == PRNG30_OK && s < log->interval; s++)
+            prng30_step(&want);
+    }
+    if (err != PRNG30_OK)
+        return err;
+
+    err = prng30_alloc_state(&got, log->width);
+    if (err == PRNG30_OK)
+        err = read_record(log, index, &got, &at);
+    if (err == PRNG30_OK && (at != index * log->interval || memcmp(want.row, got.row, (size_t)got.nwords * sizeof(uint64_t)) != 0))
+        err = PRNG30_ERR_MISMATCH;
+
+    prng30_free(&want);
+    prng30_free(&got);
+    return err;
+}
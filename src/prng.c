@@ -1,4 +1,5 @@
 #include "../include/prng30.h"
+#include "prng30_internal.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -6,8 +7,12 @@
 //  Rule 30:  neighbours 111 110 101 100 011 010 001 000
 //            next cell   0   0   0   1   1   1   1   0
 // Binary 00011110 = 30. Closed form: left XOR (mid OR right).
+//
+// Rows are bit-packed, 64 cells per word, so one word operation updates
+// 64 cells at once. Cell i is bit (i % 64) of word i / 64; bits above the
+// last cell in the final word are always zero.
 
-static inline uint8_t rule30(uint8_t left, uint8_t mid, uint8_t right) {
+static inline uint64_t rule30(uint64_t left, uint64_t mid, uint64_t right) {
     return left ^ (mid | right);
 }
 
@@ -19,40 +24,88 @@ static uint64_t splitmix64(uint64_t *state) {
     return z ^ (z >> 31);
 }
 
-prng30_err prng30_init(prng30_state *st, uint64_t seed, int width) {
-    if (!st)
-        return PRNG30_ERR_NULL;
+// Hybrid mode's linear part: 64 cells, null boundaries, each cell Rule 90
+// (left XOR right) or, where LIN_RULE has a 1, Rule 150 (left XOR self XOR
+// right). This rule vector was found by search so that the characteristic
+// polynomial of the update matrix, x^64 + LIN_POLY, is primitive: every
+// nonzero state lies on one cycle of length 2^64 - 1.
+#define LIN_RULE 0xF850113DE52A3B3BULL
+#define LIN_POLY 0x576D6F0838A6DBB1ULL
 
-    memset(st, 0, sizeof(*st));
+static inline uint64_t lin_step(uint64_t s) {
+    return (s << 1) ^ (s >> 1) ^ (s & LIN_RULE);
+}
 
-    if (width < PRNG30_MIN_WIDTH || width > PRNG30_MAX_WIDTH)
-        return PRNG30_ERR_BADWIDTH;
+// a * b mod (x^64 + LIN_POLY) over GF(2).
+static uint64_t poly_mulmod(uint64_t a, uint64_t b) {
+    uint64_t r = 0;
+    for (int i = 63; i >= 0; i--) {
+        r = (r << 1) ^ ((r >> 63) ? LIN_POLY : 0);
+        if ((b >> i) & 1)
+            r ^= a;
+    }
+    return r;
+}
 
-    st->row      = calloc((size_t)width, sizeof(uint8_t));
-    st->next_row = calloc((size_t)width, sizeof(uint8_t));
+// The linear CA advanced n steps. With M the update matrix and
+// r(x) = x^n mod its characteristic polynomial, M^n = r(M) by
+// Cayley-Hamilton, and r(M) s is evaluated by Horner's rule in 64 steps.
+static uint64_t lin_jump(uint64_t s, uint64_t n) {
+    uint64_t r = 1, x = 2; // the polynomials 1 and x
+    for (; n; n >>= 1) {
+        if (n & 1)
+            r = poly_mulmod(r, x);
+        x = poly_mulmod(x, x);
+    }
 
-    if (!st->row || !st->next_row) {
-        prng30_free(st);
-        return PRNG30_ERR_ALLOC;
+    uint64_t acc = 0;
+    for (int i = 63; i >= 0; i--) {
+        acc = lin_step(acc);
+        if ((r >> i) & 1)
+            acc ^= s;
     }
+    return acc;
+}
 
-    st->width = width;
+static inline int get_cell(const uint64_t *row, int i) {
+    return (int)((row[i >> 6] >> (i & 63)) & 1);
+}
+
+static inline void set_cell(uint64_t *row, int i) {
+    row[i >> 6] |= 1ULL << (i & 63);
+}
+
+static int row_all_zero(const uint64_t *row, int nwords) {
+    for (int w = 0; w < nwords; w++)
+        if (row[w])
+            return 0;
+    return 1;
+}
+
+static int row_all_one(const uint64_t *row, int width) {
+    int nwords = PRNG30_WORDS(width);
+    for (int w = 0; w < nwords - 1; w++)
+        if (row[w] != ~0ULL)
+            return 0;
+    return row[nwords - 1] == ~0ULL >> (63 - ((width - 1) & 63));
+}
+
+// Seed and warm up a state whose rows are already allocated and zeroed.
+static void seed_state(prng30_state *st, uint64_t seed) {
+    int width  = st->width;
+    int nwords = st->nwords;
+
+    // Cells 0-63 take the seed bits directly; the rest come from splitmix64.
+    st->row[0] = (width < 64) ? seed & (~0ULL >> (64 - width)) : seed;
 
     uint64_t sm_state = seed;
-    for (int i = 0; i < width; i++) {
-        st->row[i] = (i < 64) ? (uint8_t)((seed >> i) & 1) : (uint8_t)(splitmix64(&sm_state) & 1);
-    }
+    for (int i = 64; i < width; i++)
+        if (splitmix64(&sm_state) & 1)
+            set_cell(st->row, i);
 
     // All-zero and all-one initial states reach a fixed point under Rule 30.
-    int all_zero = 1, all_one = 1;
-    for (int i = 0; i < width; i++) {
-        if (st->row[i])
-            all_zero = 0;
-        if (!st->row[i])
-            all_one = 0;
-    }
-    if (all_zero || all_one)
-        st->row[width / 2] = 1;
+    if (row_all_zero(st->row, nwords) || row_all_one(st->row, width))
+        set_cell(st->row, width / 2);
 
     // width/2 warmup steps guarantee full diffusion under periodic boundaries.
     int warmup = width / 2;
@@ -60,17 +113,120 @@ prng30_err prng30_init(prng30_state *st, uint64_t seed, int width) {
         prng30_step(st);
 
     // Some symmetric seeds collapse to all-zeros during warmup; recover.
-    int live = 0;
-    for (int i = 0; i < width; i++)
-        if (st->row[i]) {
-            live = 1;
-            break;
-        }
-    if (!live) {
-        st->row[width / 2] = 1;
+    if (row_all_zero(st->row, nwords)) {
+        set_cell(st->row, width / 2);
         for (int i = 0; i < warmup; i++)
             prng30_step(st);
     }
+}
+
+// Start a new hybrid block: Rule 30 seeded afresh from the linear state.
+static void hybrid_reseed(prng30_state *st) {
+    uint64_t key = st->lin;
+    memset(st->row, 0, (size_t)st->nwords * sizeof(uint64_t));
+    seed_state(st, splitmix64(&key));
+}
+
+prng30_err prng30_alloc_state(prng30_state *st, int width) {
+    if (!st)
+        return PRNG30_ERR_NULL;
+
+    memset(st, 0, sizeof(*st));
+
+    if (width < PRNG30_MIN_WIDTH || width > PRNG30_MAX_WIDTH)
+        return PRNG30_ERR_BADWIDTH;
+
+    int nwords   = PRNG30_WORDS(width);
+    st->row      = calloc((size_t)nwords, sizeof(uint64_t));
+    st->next_row = calloc((size_t)nwords, sizeof(uint64_t));
+
+    if (!st->row || !st->next_row) {
+        prng30_free(st);
+        return PRNG30_ERR_ALLOC;
+    }
+
+    st->width  = width;
+    st->nwords = nwords;
+    return PRNG30_OK;
+}
+
+prng30_err prng30_init(prng30_state *st, uint64_t seed, int width) {
+    prng30_err err = prng30_alloc_state(st, width);
+    if (err != PRNG30_OK)
+        return err;
+
+    seed_state(st, seed);
+    return PRNG30_OK;
+}
+
+prng30_err prng30_init_hybrid(prng30_state *st, uint64_t seed, int width) {
+    // The rows are seeded and warmed up once, by hybrid_reseed below.
+    prng30_err err = prng30_alloc_state(st, width);
+    if (err != PRNG30_OK)
+        return err;
+
+    // The linear part must not start at zero, its only other cycle.
+    uint64_t sm_state = seed ^ 0x3C6EF372FE94F82BULL;
+    st->mode          = PRNG30_MODE_HYBRID;
+    st->lin           = splitmix64(&sm_state);
+    if (!st->lin)
+        st->lin = 1;
+    st->pos = 0;
+    hybrid_reseed(st);
+
+    return PRNG30_OK;
+}
+
+prng30_err prng30_jump(prng30_state *st, uint64_t n) {
+    if (!st || !st->row)
+        return PRNG30_ERR_NULL;
+    if (st->mode != PRNG30_MODE_HYBRID)
+        return PRNG30_ERR_MODE;
+
+    // Past the current block: jump the linear part to the start of the
+    // target block and reseed there, leaving less than a block to walk.
+    uint64_t target = st->pos + n;
+    uint64_t walk   = n;
+    if (n >= PRNG30_HYBRID_BLOCK - st->pos % PRNG30_HYBRID_BLOCK) {
+        uint64_t start = target - target % PRNG30_HYBRID_BLOCK;
+        st->lin        = lin_jump(st->lin, start - st->pos);
+        st->pos        = start;
+        hybrid_reseed(st);
+        walk = target - start;
+    }
+
+    for (uint64_t i = 0; i < walk; i++)
+        prng30_step(st);
+    st->lin = lin_jump(st->lin, walk);
+    st->pos = target;
+
+    return PRNG30_OK;
+}
+
+uint64_t prng30_block_seed(uint64_t seed, uint64_t index) {
+    uint64_t s   = seed;
+    uint64_t key = splitmix64(&s) ^ index;
+    return splitmix64(&key);
+}
+
+prng30_err prng30_block(uint64_t seed, int width, uint64_t index, void *buf, size_t len) {
+    if (!buf && len)
+        return PRNG30_ERR_NULL;
+    if (width < PRNG30_MIN_WIDTH || width > PRNG30_MAX_WIDTH)
+        return PRNG30_ERR_BADWIDTH;
+
+    // A throwaway state on the stack: no allocation per block.
+    uint64_t     rows[2][PRNG30_WORDS(PRNG30_MAX_WIDTH)];
+    prng30_state st;
+    memset(&st, 0, sizeof(st));
+    st.width    = width;
+    st.nwords   = PRNG30_WORDS(width);
+    st.row      = rows[0];
+    st.next_row = rows[1];
+    memset(st.row, 0, (size_t)st.nwords * sizeof(uint64_t));
+
+    seed_state(&st, prng30_block_seed(seed, index));
+    prng30_fill(&st, buf, len);
 
     return PRNG30_OK;
 }
@@ -83,17 +239,74 @@ void prng30_free(prng30_state *st) {
     memset(st, 0, sizeof(*st));
 }
 
+int prng30_cell(const prng30_state *st, int i) {
+    return get_cell(st->row, i);
+}
+
+void prng30_step_packed(uint64_t *restrict dst, const uint64_t *restrict src, int width) {
+    int      nw   = PRNG30_WORDS(width);
+    int      top  = (width - 1) & 63;
+    uint64_t mask = ~0ULL >> (63 - top);
+
+    // Periodic boundary: cell width-1 is the left neighbour of cell 0 and
+    // cell 0 is the right neighbour of cell width-1.
+    uint64_t wrap_l = (src[nw - 1] >> top) & 1;
+    uint64_t wrap_r = (src[0] & 1) << top;
+    uint64_t c;
+
+    if (nw == 1) {
+        c      = src[0];
+        dst[0] = rule30((c << 1) | wrap_l, c, (c >> 1) | wrap_r) & mask;
+        return;
+    }
+
+    c      = src[0];
+    dst[0] = rule30((c << 1) | wrap_l, c, (c >> 1) | (src[1] << 63));
+
+    for (int w = 1; w < nw - 1; w++) {
+        c      = src[w];
+        dst[w] = rule30((c << 1) | (src[w - 1] >> 63), c, (c >> 1) | (src[w + 1] << 63));
+    }
+
+    c           = src[nw - 1];
+    dst[nw - 1] = rule30((c << 1) | (src[nw - 2] >> 63), c, (c >> 1) | wrap_r) & mask;
+}
+
 void prng30_step(prng30_state *st) {
-    int n = st->width;
-    for (int j = 0; j < n; j++) {
-        uint8_t left    = st->row[(j - 1 + n) % n];
-        uint8_t mid     = st->row[j];
-        uint8_t right   = st->row[(j + 1) % n];
-        st->next_row[j] = rule30(left, mid, right);
+    prng30_step_packed(st->next_row, st->row, st->width);
+    uint64_t *tmp = st->row;
+    st->row       = st->next_row;
+    st->next_row  = tmp;
+}
+
+// Hybrid output: Rule 30 taps XOR the linear CA's cell 0, with Rule 30
+// reseeded whenever a block of PRNG30_HYBRID_BLOCK bits is complete.
+static uint64_t hybrid_generate(prng30_state *st, int nbits) {
+    int      mid   = st->width / 2;
+    int      tap   = st->width / 8;
+    int      n     = st->width;
+    int      left  = (mid - tap + n) % n;
+    int      right = (mid + tap) % n;
+    uint64_t lin   = st->lin;
+    uint64_t out   = 0;
+
+    while (nbits > 0) {
+        // Bits left before the next reseed; no per-bit boundary check.
+        uint64_t room = PRNG30_HYBRID_BLOCK - st->pos % PRNG30_HYBRID_BLOCK;
+        int      run  = (room < (uint64_t)nbits) ? (int)room : nbits;
+
+        for (int i = 0; i < run; i++) {
+            prng30_step(st);
+            lin = lin_step(lin);
+            out = (out << 1) | ((uint64_t)(get_cell(st->row, mid) ^ get_cell(st->row, left) ^ get_cell(st->row, right)) ^ (lin & 1));
+        }
+        st->lin = lin;
+        st->pos += (uint64_t)run;
+        nbits -= run;
+        if (st->pos % PRNG30_HYBRID_BLOCK == 0)
+            hybrid_reseed(st);
     }
-    uint8_t *tmp = st->row;
-    st->row      = st->next_row;
-    st->next_row = tmp;
+    return out;
 }
 
 uint64_t prng30_generate(prng30_state *st, int nbits) {
@@ -101,16 +314,20 @@ uint64_t prng30_generate(prng30_state *st, int nbits) {
         return 0;
     if (nbits > 64)
         nbits = 64;
+    if (st->mode == PRNG30_MODE_HYBRID)
+        return hybrid_generate(st, nbits);
 
-    int      mid = st->width / 2;
-    int      tap = st->width / 8;
-    int      n   = st->width;
-    uint64_t out = 0;
+    int      mid   = st->width / 2;
+    int      tap   = st->width / 8;
+    int      n     = st->width;
+    int      left  = (mid - tap + n) % n;
+    int      right = (mid + tap) % n;
+    uint64_t out   = 0;
 
     for (int i = 0; i < nbits; i++) {
         prng30_step(st);
-        uint8_t bit = st->row[mid] ^ st->row[(mid - tap + n) % n] ^ st->row[(mid + tap) % n];
-        out         = (out << 1) | (bit & 1);
+        int bit = get_cell(st->row, mid) ^ get_cell(st->row, left) ^ get_cell(st->row, right);
+        out     = (out << 1) | (uint64_t)bit;
     }
 
     return out;
@@ -119,3 +336,49 @@ uint64_t prng30_generate(prng30_state *st, int nbits) {
 double prng30_generate_double(prng30_state *st) {
     return (double)prng30_generate(st, 53) / (double)(1ULL << 53);
 }
+
+// prng30_fill for rows of one word: the row stays in a register for the
+// whole buffer instead of going through memory and a pointer swap per bit.
+static void fill_narrow(prng30_state *st, uint8_t *out, size_t len, int mid, int left, int right) {
+    int      top  = st->width - 1;
+    uint64_t mask = ~0ULL >> (63 - top);
+    uint64_t c    = st->row[0];
+
+    for (size_t i = 0; i < len; i++) {
+        uint64_t byte = 0;
+        for (int b = 0; b < 8; b++) {
+            c    = rule30((c << 1) | (c >> top), c, (c >> 1) | ((c & 1) << top)) & mask;
+            byte = (byte << 1) | (((c >> mid) ^ (c >> left) ^ (c >> right)) & 1);
+        }
+        out[i] = (uint8_t)byte;
+    }
+    st->row[0] = c;
+}
+
+void prng30_fill(prng30_state *st, void *buf, size_t len) {
+    uint8_t *out   = buf;
+    int      n     = st->width;
+    int      mid   = n / 2;
+    int      tap   = n / 8;
+    int      left  = (mid - tap + n) % n;
+    int      right = (mid + tap) % n;
+
+    if (st->mode == PRNG30_MODE_HYBRID) {
+        for (size_t i = 0; i < len; i++)
+            out[i] = (uint8_t)hybrid_generate(st, 8);
+        return;
+    }
+    if (st->nwords == 1) {
+        fill_narrow(st, out, len, mid, left, right);
+        return;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        unsigned byte = 0;
+        for (int b = 0; b < 8; b++) {
+            prng30_step(st);
+            byte = (byte << 1) | (unsigned)(get_cell(st->row, mid) ^ get_cell(st->row, left) ^ get_cell(st->row, right));
+        }
+        out[i] = (uint8_t)byte;
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef PRNG30_INTERNAL_H
+#define PRNG30_INTERNAL_H
+
+/*
+ * Helpers shared between the library's translation units. Not installed
+ * and not part of the public API.
+ */
+
+#include "../include/prng30.h"
+
+/*
+ * Zero *st and allocate zeroed rows for width cells, without seeding
+ * them; callers fill st->row themselves (from a seed, a checkpoint or a
+ * store slot).
+ * Returns PRNG30_OK, PRNG30_ERR_NULL, PRNG30_ERR_BADWIDTH or
+ * PRNG30_ERR_ALLOC. On failure *st is zeroed and prng30_free is safe.
+ */
+prng30_err prng30_alloc_state(prng30_state *st, int width);
+
+#endif /* PRNG30_INTERNAL_H */
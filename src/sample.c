@@ -0,0 +1,167 @@
+#include "../include/prng30.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Shuffling and sampling on top of prng30_generate. Each index is drawn
+// with only as many bits as its range needs, since every output bit costs
+// one CA step. Bulk shuffles generate a batch of indices ahead of the
+// swaps and prefetch their target slots, so on large arrays the cache
+// misses overlap instead of serialising.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH_RW(p) __builtin_prefetch((p), 1, 0)
+#else
+#define PREFETCH_RW(p) ((void)(p))
+#endif
+
+// Indices drawn and prefetched ahead of the swaps that use them.
+#define BATCH 32
+
+// Bits needed to represent every value in [0, bound).
+static int bits_for(uint64_t bound) {
+    int      bits = 0;
+    uint64_t v    = bound - 1;
+    while (v) {
+        bits++;
+        v >>= 1;
+    }
+    return bits;
+}
+
+uint64_t prng30_uniform(prng30_state *st, uint64_t bound) {
+    if (bound <= 1)
+        return 0;
+
+    // Rejection sampling on the smallest power-of-two range covering
+    // bound: unbiased, fewer than two draws on average.
+    int      bits = bits_for(bound);
+    uint64_t v;
+    do
+        v = prng30_generate(st, bits);
+    while (v >= bound);
+    return v;
+}
+
+static void swap_elems(uint8_t *a, uint8_t *b, size_t size) {
+    if (size == 8) {
+        uint64_t t;
+        memcpy(&t, a, 8);
+        memcpy(a, b, 8);
+        memcpy(b, &t, 8);
+    } else if (size == 4) {
+        uint32_t t;
+        memcpy(&t, a, 4);
+        memcpy(a, b, 4);
+        memcpy(b, &t, 4);
+    } else {
+        uint8_t tmp[64];
+        while (size > 0) {
+            size_t n = size < sizeof(tmp) ? size : sizeof(tmp);
+            memcpy(tmp, a, n);
+            memcpy(a, b, n);
+            memcpy(b, tmp, n);
+            a += n;
+            b += n;
+            size -= n;
+        }
+    }
+}
+
+void prng30_shuffle(prng30_state *st, void *base, size_t n, size_t size) {
+    uint8_t *arr = base;
+    size_t   idx[BATCH];
+
+    if (n < 2 || size == 0)
+        return;
+
+    // Fisher-Yates from the top: position i swaps with j in [0, i].
+    size_t i = n - 1;
+    while (i > 0) {
+        size_t batch = (i < BATCH) ? i : BATCH;
+
+        for (size_t b = 0; b < batch; b++) {
+            idx[b] = (size_t)prng30_uniform(st, (uint64_t)(i - b) + 1);
+            PREFETCH_RW(arr + idx[b] * size);
+        }
+        for (size_t b = 0; b < batch; b++, i--)
+            if (idx[b] != i)
+                swap_elems(arr + i * size, arr + idx[b] * size, size);
+    }
+}
+
+prng30_err prng30_sample(prng30_state *st, uint64_t n, size_t k, uint64_t *out) {
+    if (!st || (!out && k))
+        return PRNG30_ERR_NULL;
+    if (k > n)
+        return PRNG30_ERR_RANGE;
+    if (k == 0)
+        return PRNG30_OK;
+
+    // Floyd's algorithm needs a membership test on the chosen set; an open
+    // addressing table at most half full keeps probes short.
+    size_t cap = 16;
+    while (cap < 2 * k)
+        cap <<= 1;
+    uint64_t *table = malloc(cap * sizeof(uint64_t));
+    if (!table)
+        return PRNG30_ERR_ALLOC;
+    memset(table, 0xFF, cap * sizeof(uint64_t)); // UINT64_MAX marks an empty slot
+
+    size_t m = 0;
+    for (uint64_t j = n - k; j < n; j++) {
+        uint64_t t = prng30_uniform(st, j + 1);
+
+        // Insert t, or j if t was already chosen. j itself is never in the
+        // set yet, since earlier rounds only picked values below j.
+        for (int attempt = 0; attempt < 2; attempt++) {
+            size_t h = (size_t)((t * 0x9E3779B97F4A7C15ULL) >> 32) & (cap - 1);
+            while (table[h] != UINT64_MAX && table[h] != t)
+                h = (h + 1) & (cap - 1);
+            if (table[h] == UINT64_MAX) {
+                table[h] = t;
+                out[m++] = t;
+                break;
+            }
+            t = j;
+        }
+    }
+
+    free(table);
+    return PRNG30_OK;
+}
+
+// Uniform double in (0, 1), never 0, so its logarithm is finite.
+static double open_unit(prng30_state *st) {
+    return ((double)prng30_generate(st, 53) + 0.5) / (double)(1ULL << 53);
+}
+
+prng30_err prng30_reservoir(prng30_state *st, const void *src, size_t n, size_t size, void *dst, size_t k) {
+    const uint8_t *in  = src;
+    uint8_t       *res = dst;
+
+    if (!st || ((!src || !dst) && k))
+        return PRNG30_ERR_NULL;
+    if (k > n)
+        return PRNG30_ERR_RANGE;
+    if (k == 0)
+        return PRNG30_OK;
+
+    // Li's Algorithm L: rather than drawing for every element as in
+    // Algorithm R, jump straight to the next element that enters the
+    // reservoir. Only O(k log(n/k)) elements are drawn for and touched.
+    memcpy(res, in, k * size);
+
+    double w = exp(log(open_unit(st)) / (double)k);
+    size_t i = k - 1;
+    for (;;) {
+        double skip = floor(log(open_unit(st)) / log1p(-w));
+        if (!(skip < (double)(n - 1 - i)))
+            break;
+        i += (size_t)skip + 1;
+        memcpy(res + prng30_uniform(st, k) * size, in + i * size, size);
+        w *= exp(log(open_unit(st)) / (double)k);
+    }
+    return PRNG30_OK;
+}
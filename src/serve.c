@@ -0,0 +1,633 @@
+#define _GNU_SOURCE // accept4, pipe2
+
+#include "../include/prng30_serve.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+// Server: one epoll loop over the listening socket, a self-pipe that
+// prng30_server_stop writes to, and the connections. A connection reads
+// one 8-byte request, is served, and stops reading until its reply is
+// fully written; anything a client pipelines behind a request waits in
+// its socket until then. Epoll is level-triggered, so that data is seen
+// again on the next wakeup.
+//
+// Each width has a pool: its generator plus a ring of bytes generated
+// ahead (indices as in prng30_async: head - tail bytes buffered). Replies
+// come from the ring first and from the generator for whatever the ring
+// lacks, which keeps each width's bytes in stream order. A reply is cut
+// into CHUNK-byte pieces, one per connection per epoll round, so a large
+// request at a wide width does not stall every other connection while it
+// is generated. While any ring is short, epoll_wait does not block, and
+// each idle pass tops the emptiest ring up by REFILL bytes, little enough
+// that a request arriving meanwhile is not held up for long.
+
+#define MAX_EVENTS 256
+#define REFILL 4096
+#define CLIENT_BUF 4096
+#define CHUNK 16384 // reply bytes produced per connection per round
+#define REQUEST_BYTES 8
+
+typedef struct {
+    int          width;
+    prng30_state st;
+    uint8_t     *ring;
+    size_t       mask;
+    size_t       head;
+    size_t       tail;
+} pool;
+
+typedef struct {
+    int      fd;
+    int      slot; // index in prng30_server.conns
+    int      writing;
+    uint8_t  req[REQUEST_BYTES];
+    size_t   req_len;
+    pool    *src;     // pool the reply comes from
+    size_t   pending; // reply bytes not yet produced
+    uint8_t *out;     // current chunk: out[out_off, out_len) still to send
+    size_t   out_cap;
+    size_t   out_len;
+    size_t   out_off;
+} conn;
+
+struct prng30_server {
+    int      listen_fd;
+    int      epoll_fd;
+    int      stop_pipe[2];
+    char     path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    uint64_t seed;
+    size_t   ring_size; // 0: no reserve
+    pool    *pools;
+    int      npools;
+    int      max_pools;
+    conn   **conns;
+    int      nconns;
+    int      conn_cap;
+};
+
+void prng30_server_default_config(prng30_server_config *cfg) {
+    cfg->seed       = (uint64_t)time(NULL);
+    cfg->reserve    = 1u << 18;
+    cfg->max_widths = 16;
+}
+
+static size_t ring_level(const pool *p) {
+    return p->head - p->tail;
+}
+
+// Width's pool, created (and its generator warmed up) on first use. NULL
+// once max_widths pools exist.
+static pool *pool_for(prng30_server *s, int width) {
+    for (int i = 0; i < s->npools; i++)
+        if (s->pools[i].width == width)
+            return &s->pools[i];
+    if (s->npools == s->max_pools)
+        return NULL;
+
+    pool *p = &s->pools[s->npools];
+    memset(p, 0, sizeof(*p));
+    if (prng30_init(&p->st, s->seed, width) != PRNG30_OK)
+        return NULL;
+    if (s->ring_size) {
+        p->ring = malloc(s->ring_size);
+        if (!p->ring) {
+            prng30_free(&p->st);
+            return NULL;
+        }
+        p->mask = s->ring_size - 1;
+    }
+    p->width = width;
+    s->npools++;
+    return p;
+}
+
+// The next n bytes of the pool's stream: buffered ones, then fresh ones.
+static void pool_take(pool *p, uint8_t *dst, size_t n) {
+    size_t got = ring_level(p);
+    if (got > n)
+        got = n;
+    if (got) {
+        size_t off   = p->tail & p->mask;
+        size_t first = (got < p->mask + 1 - off) ? got : p->mask + 1 - off;
+        memcpy(dst, p->ring + off, first);
+        memcpy(dst + first, p->ring, got - first);
+        p->tail += got;
+    }
+    if (got < n)
+        prng30_fill(&p->st, dst + got, n - got);
+}
+
+static void pool_refill(pool *p) {
+    size_t n = p->mask + 1 - ring_level(p);
+    if (n > REFILL)
+        n = REFILL;
+    size_t off   = p->head & p->mask;
+    size_t first = (n < p->mask + 1 - off) ? n : p->mask + 1 - off;
+    prng30_fill(&p->st, p->ring + off, first);
+    prng30_fill(&p->st, p->ring, n - first);
+    p->head += n;
+}
+
+// The pool with the fewest buffered bytes, or NULL if every ring is full.
+static pool *emptiest(prng30_server *s) {
+    pool *best = NULL;
+    if (!s->ring_size)
+        return NULL;
+    for (int i = 0; i < s->npools; i++)
+        if (ring_level(&s->pools[i]) < s->ring_size && (!best || ring_level(&s->pools[i]) < ring_level(best)))
+            best = &s->pools[i];
+    return best;
+}
+
+static void close_conn(prng30_server *s, conn *c) {
+    close(c->fd); // also drops it from the epoll set
+    s->conns[c->slot]       = s->conns[--s->nconns];
+    s->conns[c->slot]->slot = c->slot;
+    free(c->out);
+    free(c);
+}
+
+static void accept_all(prng30_server *s) {
+    for (;;) {
+        int fd = accept4(s->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return; // EAGAIN once the backlog is empty; anything else is the client's problem
+
+        if (s->nconns == s->conn_cap) {
+            int    cap   = s->conn_cap ? 2 * s->conn_cap : 64;
+            conn **conns = realloc(s->conns, (size_t)cap * sizeof(*conns));
+            if (!conns) {
+                close(fd);
+                continue;
+            }
+            s->conns    = conns;
+            s->conn_cap = cap;
+        }
+        conn *c = calloc(1, sizeof(*c));
+        if (!c) {
+            close(fd);
+            continue;
+        }
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events   = EPOLLIN;
+        ev.data.ptr = c;
+        if (epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            free(c);
+            close(fd);
+            continue;
+        }
+        c->fd                 = fd;
+        c->slot               = s->nconns;
+        s->conns[s->nconns++] = c;
+    }
+}
+
+// Read what there is of the pending request. Returns 1 when it is
+// complete, 0 when more is to come, -1 when the connection should close.
+static int read_request(conn *c) {
+    while (c->req_len < REQUEST_BYTES) {
+        ssize_t n = read(c->fd, c->req + c->req_len, REQUEST_BYTES - c->req_len);
+        if (n > 0)
+            c->req_len += (size_t)n;
+        else if (n < 0 && errno == EINTR)
+            continue;
+        else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return 0;
+        else
+            return -1;
+    }
+    return 1;
+}
+
+static int set_events(prng30_server *s, conn *c, uint32_t events) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events   = events;
+    ev.data.ptr = c;
+    return epoll_ctl(s->epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+}
+
+// Write as much of the current chunk as the socket takes, and keep
+// EPOLLOUT set while more of the reply is to come. Returns -1 when the
+// connection should close.
+static int write_reply(prng30_server *s, conn *c) {
+    while (c->out_off < c->out_len) {
+        ssize_t n = send(c->fd, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+        if (n > 0)
+            c->out_off += (size_t)n;
+        else if (n < 0 && errno == EINTR)
+            continue;
+        else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!c->writing && set_events(s, c, EPOLLOUT) != 0)
+                return -1;
+            c->writing = 1;
+            return 0;
+        } else
+            return -1;
+    }
+    if (c->pending) {
+        // The socket is still writable, so the next round comes straight
+        // back for the next chunk, after every other ready connection.
+        if (!c->writing && set_events(s, c, EPOLLOUT) != 0)
+            return -1;
+        c->writing = 1;
+        return 0;
+    }
+    if (c->writing && set_events(s, c, EPOLLIN) != 0)
+        return -1;
+    c->writing = 0;
+    return 0;
+}
+
+static void next_chunk(conn *c) {
+    size_t n = (c->pending < CHUNK) ? c->pending : CHUNK;
+    pool_take(c->src, c->out, n);
+    c->pending -= n;
+    c->out_len = n;
+    c->out_off = 0;
+}
+
+// Send the rest of the current chunk, or produce and send the next one.
+static int continue_reply(prng30_server *s, conn *c) {
+    if (c->out_off == c->out_len && c->pending)
+        next_chunk(c);
+    return write_reply(s, c);
+}
+
+static int serve(prng30_server *s, conn *c) {
+    uint32_t width, len;
+    memcpy(&width, c->req, 4);
+    memcpy(&len, c->req + 4, 4);
+    c->req_len = 0;
+
+    if (width < PRNG30_MIN_WIDTH || width > PRNG30_MAX_WIDTH || len > PRNG30_SERVE_MAX_REQUEST)
+        return -1;
+    pool *p = pool_for(s, (int)width);
+    if (!p)
+        return -1;
+
+    size_t cap = (len < CHUNK) ? len : CHUNK;
+    if (cap > c->out_cap) {
+        uint8_t *out = realloc(c->out, cap);
+        if (!out)
+            return -1;
+        c->out     = out;
+        c->out_cap = cap;
+    }
+    c->src     = p;
+    c->pending = len;
+    next_chunk(c);
+    return write_reply(s, c);
+}
+
+prng30_err prng30_server_run(prng30_server *s) {
+    struct epoll_event ev[MAX_EVENTS];
+    conn              *ready[MAX_EVENTS];
+
+    for (;;) {
+        pool *low = emptiest(s);
+        int   n   = epoll_wait(s->epoll_fd, ev, MAX_EVENTS, low ? 0 : -1);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return PRNG30_ERR_IO;
+        if (n == 0) {
+            pool_refill(low);
+            continue;
+        }
+
+        // Read every ready request, and note every connection ready for more
+        // of its reply, before generating or writing anything.
+        int nready = 0;
+        for (int i = 0; i < n; i++) {
+            void *tag = ev[i].data.ptr;
+            if (tag == &s->stop_pipe[0]) {
+                char    drain[16];
+                ssize_t r = read(s->stop_pipe[0], drain, sizeof(drain));
+                (void)r;
+                return PRNG30_OK;
+            }
+            if (tag == &s->listen_fd) {
+                accept_all(s);
+                continue;
+            }
+
+            conn *c = tag;
+            int   rc;
+            if (c->writing)
+                rc = (ev[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) != 0;
+            else
+                rc = read_request(c);
+            if (rc < 0)
+                close_conn(s, c);
+            else if (rc == 1)
+                ready[nready++] = c;
+        }
+
+        for (int i = 0; i < nready; i++) {
+            conn *c = ready[i];
+            if ((c->writing ? continue_reply(s, c) : serve(s, c)) < 0)
+                close_conn(s, c);
+        }
+    }
+}
+
+void prng30_server_stop(prng30_server *s) {
+    ssize_t r = write(s->stop_pipe[1], "", 1);
+    (void)r;
+}
+
+// Whether the socket at addr cannot be replaced: a server accepts on it,
+// or probing it fails for any reason other than nobody listening.
+static int socket_in_use(const struct sockaddr_un *addr) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return 1;
+    int in_use = connect(fd, (const struct sockaddr *)addr, sizeof(*addr)) == 0 || errno != ECONNREFUSED;
+    close(fd);
+    return in_use;
+}
+
+prng30_err prng30_server_create(prng30_server **out, const char *path, const prng30_server_config *cfg) {
+    prng30_server_config def;
+    struct sockaddr_un   addr;
+    struct epoll_event   ev;
+
+    if (!out)
+        return PRNG30_ERR_NULL;
+    *out = NULL;
+    if (!cfg) {
+        prng30_server_default_config(&def);
+        cfg = &def;
+    }
+    if (!path)
+        path = PRNG30_SERVE_DEFAULT_PATH;
+    if (strlen(path) >= sizeof(addr.sun_path))
+        return PRNG30_ERR_IO;
+    // Past the largest power of two a size_t holds, rounding up would wrap.
+    if (cfg->reserve > ~(SIZE_MAX >> 1))
+        return PRNG30_ERR_RANGE;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    // A socket left behind by a server that has exited is replaced. One
+    // that still accepts connections belongs to a live server, and
+    // anything that is not a socket is not ours to remove.
+    struct stat sb;
+    int         stale = lstat(path, &sb) == 0;
+    if (stale && (!S_ISSOCK(sb.st_mode) || socket_in_use(&addr)))
+        return PRNG30_ERR_IO;
+
+    prng30_server *s = calloc(1, sizeof(*s));
+    if (!s)
+        return PRNG30_ERR_ALLOC;
+    s->listen_fd    = -1;
+    s->epoll_fd     = -1;
+    s->stop_pipe[0] = -1;
+    s->stop_pipe[1] = -1;
+    s->seed         = cfg->seed;
+    s->max_pools    = (cfg->max_widths > 0) ? cfg->max_widths : 1;
+    if (cfg->reserve) {
+        s->ring_size = REFILL;
+        while (s->ring_size < cfg->reserve)
+            s->ring_size <<= 1;
+    }
+    s->pools = calloc((size_t)s->max_pools, sizeof(pool));
+    if (!s->pools) {
+        free(s);
+        return PRNG30_ERR_ALLOC;
+    }
+
+    s->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    s->epoll_fd  = epoll_create1(EPOLL_CLOEXEC);
+    if (s->listen_fd < 0 || s->epoll_fd < 0 || pipe2(s->stop_pipe, O_NONBLOCK | O_CLOEXEC) != 0) {
+        prng30_server_destroy(s);
+        return PRNG30_ERR_IO;
+    }
+
+    if (stale)
+        unlink(path);
+    if (bind(s->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(s->listen_fd, SOMAXCONN) != 0) {
+        prng30_server_destroy(s);
+        return PRNG30_ERR_IO;
+    }
+    strcpy(s->path, path); // from here on, destroy removes the socket file
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events   = EPOLLIN;
+    ev.data.ptr = &s->listen_fd;
+    int ok      = epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, s->listen_fd, &ev) == 0;
+    ev.data.ptr = &s->stop_pipe[0];
+    ok          = ok && epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, s->stop_pipe[0], &ev) == 0;
+    if (!ok) {
+        prng30_server_destroy(s);
+        return PRNG30_ERR_IO;
+    }
+
+    *out = s;
+    return PRNG30_OK;
+}
+
+void prng30_server_destroy(prng30_server *s) {
+    if (!s)
+        return;
+    while (s->nconns > 0)
+        close_conn(s, s->conns[0]);
+    free(s->conns);
+    for (int i = 0; i < s->npools; i++) {
+        prng30_free(&s->pools[i].st);
+        free(s->pools[i].ring);
+    }
+    free(s->pools);
+
+    if (s->listen_fd >= 0)
+        close(s->listen_fd);
+    if (s->path[0])
+        unlink(s->path);
+    if (s->epoll_fd >= 0)
+        close(s->epoll_fd);
+    for (int i = 0; i < 2; i++)
+        if (s->stop_pipe[i] >= 0)
+            close(s->stop_pipe[i]);
+    free(s);
+}
+
+// Client: bytes not yet handed out are buf[pos, len); bits left over from
+// generate are the low `have` bits of acc, used MSB first. Fill and
+// generate share both, so mixing them reads one continuous bit stream.
+
+struct prng30_client {
+    int        fd;
+    int        width;
+    prng30_err status;
+    size_t     pos;
+    size_t     len;
+    uint64_t   acc;
+    int        have;
+    uint8_t    buf[CLIENT_BUF];
+};
+
+prng30_err prng30_client_connect(prng30_client **out, const char *path, int width) {
+    struct sockaddr_un addr;
+
+    if (!out)
+        return PRNG30_ERR_NULL;
+    *out = NULL;
+    if (width < PRNG30_MIN_WIDTH || width > PRNG30_MAX_WIDTH)
+        return PRNG30_ERR_BADWIDTH;
+    if (!path)
+        path = PRNG30_SERVE_DEFAULT_PATH;
+    if (strlen(path) >= sizeof(addr.sun_path))
+        return PRNG30_ERR_IO;
+
+    prng30_client *c = calloc(1, sizeof(*c));
+    if (!c)
+        return PRNG30_ERR_ALLOC;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    c->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (c->fd < 0 || connect(c->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        if (c->fd >= 0)
+            close(c->fd);
+        free(c);
+        return PRNG30_ERR_IO;
+    }
+    c->width = width;
+    *out     = c;
+    return PRNG30_OK;
+}
+
+void prng30_client_close(prng30_client *c) {
+    if (!c)
+        return;
+    close(c->fd);
+    free(c);
+}
+
+prng30_err prng30_client_status(const prng30_client *c) {
+    return c->status;
+}
+
+// n bytes from the server into dst, one request per PRNG30_SERVE_MAX_REQUEST.
+static prng30_err request(prng30_client *c, uint8_t *dst, size_t n) {
+    while (n > 0 && c->status == PRNG30_OK) {
+        uint32_t len = (n < PRNG30_SERVE_MAX_REQUEST) ? (uint32_t)n : PRNG30_SERVE_MAX_REQUEST;
+        uint32_t width = (uint32_t)c->width;
+        uint8_t  req[REQUEST_BYTES];
+        memcpy(req, &width, 4);
+        memcpy(req + 4, &len, 4);
+
+        // MSG_NOSIGNAL: a server that went away is an error, not SIGPIPE.
+        size_t done = 0;
+        while (done < REQUEST_BYTES) {
+            ssize_t r = send(c->fd, req + done, REQUEST_BYTES - done, MSG_NOSIGNAL);
+            if (r < 0 && errno == EINTR)
+                continue;
+            if (r <= 0) {
+                c->status = PRNG30_ERR_IO;
+                return c->status;
+            }
+            done += (size_t)r;
+        }
+        for (done = 0; done < len;) {
+            ssize_t r = recv(c->fd, dst + done, len - done, 0);
+            if (r < 0 && errno == EINTR)
+                continue;
+            if (r <= 0) {
+                c->status = PRNG30_ERR_IO;
+                return c->status;
+            }
+            done += (size_t)r;
+        }
+        dst += len;
+        n -= len;
+    }
+    return c->status;
+}
+
+// The next len bytes of the byte stream: buffered ones, then from the
+// server.
+static prng30_err take_bytes(prng30_client *c, uint8_t *out, size_t len) {
+    size_t take = c->len - c->pos;
+    if (take > len)
+        take = len;
+    memcpy(out, c->buf + c->pos, take);
+    c->pos += take;
+    out += take;
+    len -= take;
+
+    if (len >= CLIENT_BUF)
+        return request(c, out, len);
+    if (len > 0) {
+        if (request(c, c->buf, CLIENT_BUF) != PRNG30_OK)
+            return c->status;
+        memcpy(out, c->buf, len);
+        c->pos = len;
+        c->len = CLIENT_BUF;
+    }
+    return PRNG30_OK;
+}
+
+prng30_err prng30_client_fill(prng30_client *c, void *buf, size_t len) {
+    uint8_t *out = buf;
+
+    if (!c || (!buf && len))
+        return PRNG30_ERR_NULL;
+    if (c->status != PRNG30_OK)
+        return c->status;
+    if (take_bytes(c, out, len) != PRNG30_OK)
+        return c->status;
+
+    // After a generate that ended mid-byte the stream continues from the
+    // bits it left over, as prng30_fill does after prng30_generate: shift
+    // the bytes down by `have` bits, and keep the same number from the
+    // last one for later.
+    if (c->have) {
+        for (size_t i = 0; i < len; i++) {
+            uint8_t b = out[i];
+            out[i]    = (uint8_t)((c->acc << (8 - c->have)) | ((unsigned)b >> c->have));
+            c->acc    = b;
+        }
+    }
+    return PRNG30_OK;
+}
+
+uint64_t prng30_client_generate(prng30_client *c, int nbits) {
+    uint64_t v = 0;
+
+    if (nbits <= 0)
+        return 0;
+    if (nbits > 64)
+        nbits = 64;
+    if (c->status != PRNG30_OK)
+        return 0;
+    while (nbits > 0) {
+        if (c->have == 0) {
+            uint8_t byte;
+            if (take_bytes(c, &byte, 1) != PRNG30_OK)
+                return 0;
+            c->acc  = byte;
+            c->have = 8;
+        }
+        int take = (nbits < c->have) ? nbits : c->have;
+        v        = (v << take) | ((c->acc >> (c->have - take)) & ((1u << take) - 1));
+        c->have -= take;
+        nbits -= take;
+    }
+    return v;
+}
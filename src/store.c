@@ -0,0 +1,315 @@
+#include "../include/prng30_store.h"
+#include "prng30_internal.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MAGIC "PRNG30ST"
+#define VERSION 1
+#define HEADER_BYTES 64
+
+// Written in host order; reads back differently on the other byte order.
+#define BYTE_ORDER_TAG 0x0102030405060708ULL
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+// Power of two up to a cache line, whole cache lines above.
+static size_t stride_for(int width) {
+    size_t bytes  = 8 * (size_t)PRNG30_WORDS(width);
+    size_t stride = 8;
+    while (stride < bytes && stride < 64)
+        stride <<= 1;
+    return (bytes <= 64) ? stride : (bytes + 63) / 64 * 64;
+}
+
+static uint64_t *slot(const prng30_store *s, uint64_t id) {
+    return (uint64_t *)(void *)(s->base + HEADER_BYTES + (size_t)id * s->stride);
+}
+
+static void mark_dirty(prng30_store *s, size_t off, size_t len) {
+    for (size_t p = off / s->page; p <= (off + len - 1) / s->page; p++)
+        __atomic_fetch_or(&s->dirty[p / 64], 1ULL << (p % 64), __ATOMIC_RELAXED);
+}
+
+static void mark_slot(prng30_store *s, uint64_t id) {
+    mark_dirty(s, HEADER_BYTES + (size_t)id * s->stride, 8 * (size_t)s->nwords);
+}
+
+// Map fd, whose first `size` bytes hold a store of the given geometry.
+static prng30_err map_store(prng30_store *s, int fd, size_t size, int width, uint64_t count) {
+    long page = sysconf(_SC_PAGESIZE);
+
+    s->fd     = fd;
+    s->size   = size;
+    s->width  = width;
+    s->nwords = PRNG30_WORDS(width);
+    s->count  = count;
+    s->stride = stride_for(width);
+    s->page   = (page > 0) ? (size_t)page : 4096;
+    s->npages = (size + s->page - 1) / s->page;
+    s->dirty  = calloc((s->npages + 63) / 64, sizeof(uint64_t));
+    if (!s->dirty)
+        return PRNG30_ERR_ALLOC;
+
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED)
+        return PRNG30_ERR_IO;
+    s->base = base;
+    return PRNG30_OK;
+}
+
+static prng30_err fail(prng30_store *s, int fd, prng30_err err) {
+    if (s->base)
+        munmap(s->base, s->size);
+    free(s->dirty);
+    if (fd >= 0)
+        close(fd);
+    memset(s, 0, sizeof(*s));
+    s->fd = -1;
+    return err;
+}
+
+prng30_err prng30_store_create(prng30_store *s, const char *path, int width, uint64_t count) {
+    if (!s)
+        return PRNG30_ERR_NULL;
+    memset(s, 0, sizeof(*s));
+    s->fd = -1;
+    if (!path)
+        return PRNG30_ERR_NULL;
+    if (width < PRNG30_MIN_WIDTH || width > PRNG30_MAX_WIDTH)
+        return PRNG30_ERR_BADWIDTH;
+
+    size_t stride = stride_for(width);
+    if (count == 0 || count > (SIZE_MAX / 2 - HEADER_BYTES) / stride)
+        return PRNG30_ERR_RANGE;
+    size_t size = HEADER_BYTES + (size_t)count * stride;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return PRNG30_ERR_IO;
+
+    // The slots are a hole in the file until first written.
+    if (ftruncate(fd, (off_t)size) != 0)
+        return fail(s, fd, PRNG30_ERR_IO);
+
+    prng30_err err = map_store(s, fd, size, width, count);
+    if (err != PRNG30_OK)
+        return fail(s, fd, err);
+
+    memcpy(s->base, MAGIC, 8);
+    put_u32(s->base + 8, VERSION);
+    put_u32(s->base + 12, (uint32_t)width);
+    put_u64(s->base + 16, count);
+    put_u64(s->base + 24, stride);
+    *(uint64_t *)(void *)(s->base + 32) = BYTE_ORDER_TAG;
+    mark_dirty(s, 0, HEADER_BYTES);
+    return PRNG30_OK;
+}
+
+prng30_err prng30_store_open(prng30_store *s, const char *path) {
+    uint8_t     hdr[HEADER_BYTES];
+    uint64_t    tag;
+    struct stat sb;
+
+    if (!s)
+        return PRNG30_ERR_NULL;
+    memset(s, 0, sizeof(*s));
+    s->fd = -1;
+    if (!path)
+        return PRNG30_ERR_NULL;
+
+    int fd = open(path, O_RDWR);
+    if (fd < 0)
+        return PRNG30_ERR_IO;
+    if (pread(fd, hdr, HEADER_BYTES, 0) != HEADER_BYTES || memcmp(hdr, MAGIC, 8) != 0 || get_u32(hdr + 8) != VERSION)
+        return fail(s, fd, PRNG30_ERR_FORMAT);
+
+    int      width  = (int)get_u32(hdr + 12);
+    uint64_t count  = get_u64(hdr + 16);
+    uint64_t stride = get_u64(hdr + 24);
+    memcpy(&tag, hdr + 32, 8);
+
+    // The header must describe a store this build would have written, and
+    // the file must hold every slot it promises.
+    if (width < PRNG30_MIN_WIDTH || width > PRNG30_MAX_WIDTH || stride != stride_for(width) || tag != BYTE_ORDER_TAG ||
+        count == 0 || count > (SIZE_MAX / 2 - HEADER_BYTES) / stride)
+        return fail(s, fd, PRNG30_ERR_FORMAT);
+    size_t size = HEADER_BYTES + (size_t)count * (size_t)stride;
+    if (fstat(fd, &sb) != 0 || (uint64_t)sb.st_size < size)
+        return fail(s, fd, PRNG30_ERR_FORMAT);
+
+    prng30_err err = map_store(s, fd, size, width, count);
+    return (err == PRNG30_OK) ? PRNG30_OK : fail(s, fd, err);
+}
+
+void prng30_store_close(prng30_store *s) {
+    if (!s)
+        return;
+    if (s->base) {
+        prng30_store_flush(s, 0);
+        munmap(s->base, s->size);
+        close(s->fd);
+    }
+    free(s->dirty);
+    memset(s, 0, sizeof(*s));
+    s->fd = -1;
+}
+
+prng30_err prng30_store_seed(prng30_store *s, uint64_t id, uint64_t seed) {
+    prng30_state st;
+
+    if (!s || !s->base)
+        return PRNG30_ERR_NULL;
+    if (id >= s->count)
+        return PRNG30_ERR_RANGE;
+
+    prng30_err err = prng30_init(&st, seed, s->width);
+    if (err != PRNG30_OK)
+        return err;
+    memcpy(slot(s, id), st.row, 8 * (size_t)s->nwords);
+    prng30_free(&st);
+    mark_slot(s, id);
+    return PRNG30_OK;
+}
+
+// A state whose current row is the mapped slot and whose second row is
+// the caller's scratch, so the core routines step the slot in place.
+static void view_slot(const prng30_store *s, uint64_t id, prng30_state *st, uint64_t *scratch) {
+    memset(st, 0, sizeof(*st));
+    st->width    = s->width;
+    st->nwords   = s->nwords;
+    st->row      = slot(s, id);
+    st->next_row = scratch;
+}
+
+// After an odd number of steps the latest row is in scratch.
+static void settle(prng30_store *s, uint64_t id, const prng30_state *st) {
+    uint64_t *row = slot(s, id);
+    if (st->row != row)
+        memcpy(row, st->row, 8 * (size_t)s->nwords);
+    mark_slot(s, id);
+}
+
+uint64_t prng30_store_generate(prng30_store *s, uint64_t id, int nbits) {
+    uint64_t     scratch[PRNG30_WORDS(PRNG30_MAX_WIDTH)];
+    prng30_state st;
+
+    if (id >= s->count)
+        return 0;
+    view_slot(s, id, &st, scratch);
+    uint64_t v = prng30_generate(&st, nbits);
+    settle(s, id, &st);
+    return v;
+}
+
+void prng30_store_fill(prng30_store *s, uint64_t id, void *buf, size_t len) {
+    uint64_t     scratch[PRNG30_WORDS(PRNG30_MAX_WIDTH)];
+    prng30_state st;
+
+    if (id >= s->count || len == 0)
+        return;
+    view_slot(s, id, &st, scratch);
+    prng30_fill(&st, buf, len);
+    settle(s, id, &st);
+}
+
+prng30_err prng30_store_load(const prng30_store *s, uint64_t id, prng30_state *st) {
+    if (!st)
+        return PRNG30_ERR_NULL;
+    memset(st, 0, sizeof(*st));
+    if (!s || !s->base)
+        return PRNG30_ERR_NULL;
+    if (id >= s->count)
+        return PRNG30_ERR_RANGE;
+
+    prng30_err err = prng30_alloc_state(st, s->width);
+    if (err != PRNG30_OK)
+        return err;
+    memcpy(st->row, slot(s, id), 8 * (size_t)s->nwords);
+    return PRNG30_OK;
+}
+
+prng30_err prng30_store_save(prng30_store *s, uint64_t id, const prng30_state *st) {
+    if (!s || !s->base || !st || !st->row)
+        return PRNG30_ERR_NULL;
+    if (id >= s->count)
+        return PRNG30_ERR_RANGE;
+    if (st->width != s->width)
+        return PRNG30_ERR_BADWIDTH;
+    if (st->mode != PRNG30_MODE_PLAIN)
+        return PRNG30_ERR_MODE;
+
+    memcpy(slot(s, id), st->row, 8 * (size_t)s->nwords);
+    mark_slot(s, id);
+    return PRNG30_OK;
+}
+
+static int page_dirty(const prng30_store *s, size_t p) {
+    return (int)((s->dirty[p / 64] >> (p % 64)) & 1);
+}
+
+prng30_err prng30_store_flush(prng30_store *s, size_t max_pages) {
+    size_t budget = max_pages ? max_pages : SIZE_MAX;
+    int    ok     = 1;
+
+    if (!s || !s->base)
+        return PRNG30_ERR_NULL;
+
+    for (size_t p = 0; p < s->npages && budget > 0; p++) {
+        if (!s->dirty[p / 64]) {
+            p |= 63; // skip a clean bitmap word
+            continue;
+        }
+        if (!page_dirty(s, p))
+            continue;
+
+        // Flush runs alone (see prng30_store.h), so plain stores clear the
+        // bits; only writers on different ids race on the bitmap.
+        size_t run = 0;
+        while (p + run < s->npages && run < budget && page_dirty(s, p + run)) {
+            s->dirty[(p + run) / 64] &= ~(1ULL << ((p + run) % 64));
+            run++;
+        }
+        size_t len = run * s->page;
+        if (p * s->page + len > s->size)
+            len = s->size - p * s->page;
+        if (msync(s->base + p * s->page, len, MS_SYNC) != 0)
+            ok = 0;
+        budget -= run;
+        p += run - 1;
+    }
+    return ok ? PRNG30_OK : PRNG30_ERR_IO;
+}
+
+size_t prng30_store_dirty_pages(const prng30_store *s) {
+    size_t n = 0;
+    for (size_t w = 0; w < (s->npages + 63) / 64; w++)
+        n += (size_t)__builtin_popcountll(s->dirty[w]);
+    return n;
+}
@@ -0,0 +1,521 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // sched_getaffinity, pthread_setaffinity_np
+#endif
+
+#include "../include/prng30_wide.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+// The row is double-buffered: an epoch of up to `halo` generations reads
+// row[cur] and writes row[cur ^ 1]. Thread i owns cells [c0, c1) of both
+// buffers. Per epoch it walks its cells in tiles; each tile, together with
+// halo cells either side, is copied into a private scratch buffer, stepped
+// there with non-periodic word shifts, and its now-exact middle written
+// to the other buffer. Nobody writes what anybody else reads in the same
+// epoch, so the only synchronisation is one barrier per epoch.
+//
+// Scratch cell p of a tile starting at c0 is row cell (c0 - 64 * hwords + p)
+// mod width. Unrolling the ring like this is exact for any width, even one
+// narrower than the halo. After s steps scratch cells [s, total - s) are
+// still exact; the steps skip words entirely outside that range.
+//
+// Slice boundaries are page aligned when the row is large enough, and each
+// thread zeroes its own slices before seeding, so first-touch placement
+// puts them on that thread's NUMA node.
+
+// Words per tile; two tile buffers stay within L1/L2.
+#define TILE_WORDS 2048
+#define TILE_CELLS (64L * TILE_WORDS)
+
+// Output generations computed per refill, in epochs.
+#define JOB_EPOCHS 16
+
+#define MAX_HALO (1 << 16)
+
+static inline uint64_t rule30(uint64_t left, uint64_t mid, uint64_t right) {
+    return left ^ (mid | right);
+}
+
+// Same expansion as prng30_init, so both see the same initial row.
+static uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    int             count;
+    int             waiting;
+    unsigned        phase;
+} barrier;
+
+static void barrier_wait(barrier *b) {
+    pthread_mutex_lock(&b->lock);
+    unsigned phase = b->phase;
+    if (++b->waiting >= b->count) {
+        b->waiting = 0;
+        b->phase++;
+        pthread_cond_broadcast(&b->cond);
+    } else {
+        while (phase == b->phase)
+            pthread_cond_wait(&b->cond, &b->lock);
+    }
+    pthread_mutex_unlock(&b->lock);
+}
+
+struct part {
+    prng30_wide *w;
+    long         c0, c1;   // owned cells
+    int          cpu;      // CPU to bind to, or -1
+    size_t       sbwords;  // words per scratch buffer, guards included
+    uint64_t    *scratch;  // two tile buffers
+    int          ok;
+    pthread_t    thread;
+};
+
+struct prng30_wide {
+    int       width;
+    int       nwords;
+    int       nthreads;
+    int       nstarted; // helper threads running
+    int       halo;
+    int       hwords;
+    uint64_t *row[2];
+    int       cur;
+
+    // Tap cells and their values for each generation of the last job,
+    // bit g of tapbits[t] for job generation g.
+    long      tap[3];
+    uint64_t *tapbits[3];
+    size_t    out_cap;
+    size_t    out_pos;
+    size_t    out_len;
+
+    // Current job, read by the helpers after the start barrier.
+    uint64_t job_gens;
+    int      job_record;
+    int      quit;
+
+    barrier      bar;
+    struct part *parts;
+};
+
+void prng30_wide_default_config(prng30_wide_config *cfg) {
+    cfg->threads = 0;
+    cfg->halo    = 512;
+    cfg->warmup  = -1;
+    cfg->pin     = 0;
+}
+
+// 64 cells starting at cell x, wrapping at width.
+static uint64_t load64(const uint64_t *row, long width, long x) {
+    if (x + 64 <= width) {
+        long w = x >> 6;
+        int  s = (int)(x & 63);
+        return s ? (row[w] >> s) | (row[w + 1] << (64 - s)) : row[w];
+    }
+    uint64_t v = 0;
+    for (int b = 0; b < 64; b++) {
+        v |= ((row[x >> 6] >> (x & 63)) & 1) << b;
+        if (++x == width)
+            x = 0;
+    }
+    return v;
+}
+
+// One generation of words [lo, hi). src[lo - 1] and src[hi] must be
+// readable; cells whose neighbourhood reaches past the range come out
+// wrong, and the caller treats them as outside the valid region.
+static void step_span(uint64_t *restrict dst, const uint64_t *restrict src, int lo, int hi) {
+    for (int w = lo; w < hi; w++) {
+        uint64_t c = src[w];
+        dst[w]     = rule30((c << 1) | (src[w - 1] >> 63), c, (c >> 1) | (src[w + 1] << 63));
+    }
+}
+
+// Advance cells [c0, c1) by `steps` generations, row[cur] to row[cur ^ 1].
+static void run_tile(prng30_wide *w, struct part *p, long c0, long c1, int cur, int steps, uint64_t gen) {
+    const uint64_t *src   = w->row[cur];
+    uint64_t       *dst   = w->row[cur ^ 1];
+    long            width = w->width;
+    int             H     = w->hwords;
+    long            total = 128L * H + (c1 - c0);
+    int             lw    = (int)((total + 63) / 64);
+
+    // Buffers keep a guard word either side so step_span never branches.
+    uint64_t *a = p->scratch + 1;
+    uint64_t *b = p->scratch + p->sbwords + 1;
+
+    long x = ((c0 - 64L * H) % width + width) % width;
+    for (int i = 0; i < lw; i++) {
+        a[i] = load64(src, width, x);
+        x    = (x + 64) % width;
+    }
+
+    // Tap cells inside this tile, as scratch bit positions.
+    long tpos[3];
+    int  tidx[3], ntaps = 0;
+    for (int t = 0; w->job_record && t < 3; t++)
+        if (w->tap[t] >= c0 && w->tap[t] < c1) {
+            tpos[ntaps]   = 64L * H + w->tap[t] - c0;
+            tidx[ntaps++] = t;
+        }
+
+    for (int s = 1; s <= steps; s++) {
+        step_span(b, a, s / 64, (int)((total - s + 63) / 64));
+        uint64_t *tmp = a;
+        a             = b;
+        b             = tmp;
+
+        uint64_t g = gen + (uint64_t)s - 1;
+        for (int t = 0; t < ntaps; t++) {
+            uint64_t  bit  = (a[tpos[t] >> 6] >> (tpos[t] & 63)) & 1;
+            uint64_t *word = &w->tapbits[tidx[t]][g >> 6];
+            *word          = (*word & ~(1ULL << (g & 63))) | (bit << (g & 63));
+        }
+    }
+
+    int own = (int)((c1 - c0 + 63) / 64);
+    memcpy(dst + c0 / 64, a + H, (size_t)own * sizeof(uint64_t));
+    if (c1 == width && (width & 63))
+        dst[c0 / 64 + own - 1] &= ~0ULL >> (64 - (width & 63));
+}
+
+static void run_part(prng30_wide *w, struct part *p) {
+    int      cur  = w->cur;
+    uint64_t gens = w->job_gens;
+
+    for (uint64_t done = 0; done < gens;) {
+        int steps = (gens - done < (uint64_t)w->halo) ? (int)(gens - done) : w->halo;
+        for (long c = p->c0; c < p->c1; c += TILE_CELLS)
+            run_tile(w, p, c, (c + TILE_CELLS < p->c1) ? c + TILE_CELLS : p->c1, cur, steps, done);
+        barrier_wait(&w->bar);
+        cur ^= 1;
+        done += (uint64_t)steps;
+    }
+}
+
+static void pin_to(int cpu) {
+#if defined(__linux__)
+    if (cpu >= 0) {
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET((size_t)cpu, &one);
+        pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+    }
+#else
+    (void)cpu;
+#endif
+}
+
+// Runs on the thread that owns the part, so its memory is placed there.
+static void part_init(struct part *p) {
+    prng30_wide *w = p->w;
+    size_t       n = (size_t)((p->c1 - p->c0 + 63) / 64);
+
+    pin_to(p->cpu);
+    p->sbwords = TILE_WORDS + 2 * (size_t)w->hwords + 3;
+    p->scratch = calloc(2 * p->sbwords, sizeof(uint64_t));
+    p->ok      = p->scratch != NULL;
+    memset(w->row[0] + p->c0 / 64, 0, n * sizeof(uint64_t));
+    memset(w->row[1] + p->c0 / 64, 0, n * sizeof(uint64_t));
+}
+
+static void *helper(void *arg) {
+    struct part *p = arg;
+    prng30_wide *w = p->w;
+
+    part_init(p);
+    barrier_wait(&w->bar);
+    for (;;) {
+        barrier_wait(&w->bar);
+        if (w->quit)
+            break;
+        run_part(w, p);
+    }
+    return NULL;
+}
+
+// Run `gens` generations on all threads, the caller acting as thread 0.
+static void run(prng30_wide *w, uint64_t gens, int record) {
+    if (gens == 0)
+        return;
+    w->job_gens   = gens;
+    w->job_record = record;
+    if (w->nthreads > 1)
+        barrier_wait(&w->bar);
+    run_part(w, &w->parts[0]);
+
+    uint64_t epochs = (gens + (uint64_t)w->halo - 1) / (uint64_t)w->halo;
+    w->cur ^= (int)(epochs & 1);
+}
+
+static void refill(prng30_wide *w, uint64_t want) {
+    uint64_t gens = (want + (uint64_t)w->halo - 1) / (uint64_t)w->halo * (uint64_t)w->halo;
+    if (gens > w->out_cap)
+        gens = w->out_cap;
+    run(w, gens, 1);
+    w->out_pos = 0;
+    w->out_len = (size_t)gens;
+}
+
+// Next output bit; `want` is how many the caller still needs, to size
+// a refill.
+static uint64_t next_bit(prng30_wide *w, uint64_t want) {
+    if (w->out_pos == w->out_len)
+        refill(w, want);
+    size_t   g = w->out_pos++;
+    uint64_t x = w->tapbits[0][g >> 6] ^ w->tapbits[1][g >> 6] ^ w->tapbits[2][g >> 6];
+    return (x >> (g & 63)) & 1;
+}
+
+static int row_all_zero(const prng30_wide *w) {
+    const uint64_t *row = w->row[w->cur];
+    for (int i = 0; i < w->nwords; i++)
+        if (row[i])
+            return 0;
+    return 1;
+}
+
+static int row_all_one(const prng30_wide *w) {
+    const uint64_t *row = w->row[w->cur];
+    for (int i = 0; i < w->nwords - 1; i++)
+        if (row[i] != ~0ULL)
+            return 0;
+    return row[w->nwords - 1] == ~0ULL >> (63 - ((w->width - 1) & 63));
+}
+
+static void set_cell(prng30_wide *w, long i) {
+    w->row[w->cur][i >> 6] |= 1ULL << (i & 63);
+}
+
+// As seed_state in prng.c, with the warmup run on all threads.
+static void seed_wide(prng30_wide *w, uint64_t seed, uint64_t warmup) {
+    int width = w->width;
+
+    w->row[w->cur][0] = (width < 64) ? seed & (~0ULL >> (64 - width)) : seed;
+
+    uint64_t sm_state = seed;
+    for (long i = 64; i < width; i++)
+        if (splitmix64(&sm_state) & 1)
+            set_cell(w, i);
+
+    if (row_all_zero(w) || row_all_one(w))
+        set_cell(w, width / 2);
+
+    run(w, warmup, 0);
+
+    if (row_all_zero(w)) {
+        set_cell(w, width / 2);
+        run(w, warmup, 0);
+    }
+}
+
+// Split the row into nthreads slices of whole words, page- or
+// cache-line-aligned when every slice can still get at least one unit.
+static void partition(prng30_wide *w, const int *cpus) {
+    long W    = w->nwords;
+    long T    = w->nthreads;
+    long gran = (W >= 512 * T) ? 512 : (W >= 8 * T) ? 8 : 1;
+
+    for (long i = 0; i < T; i++) {
+        struct part *p = &w->parts[i];
+        long         w0 = W * i / T / gran * gran;
+        long         w1 = (i == T - 1) ? W : W * (i + 1) / T / gran * gran;
+        p->w            = w;
+        p->c0           = 64 * w0;
+        p->c1           = (64 * w1 < w->width) ? 64 * w1 : w->width;
+        p->cpu          = (cpus && i > 0) ? cpus[i] : -1;
+    }
+}
+
+// CPUs this process may run on, one per thread, reused round robin.
+static int *allowed_cpus(int n) {
+#if defined(__linux__)
+    cpu_set_t set;
+    int      *cpus  = malloc((size_t)n * sizeof(int));
+    int       count = 0;
+    if (!cpus || sched_getaffinity(0, sizeof(set), &set) != 0 || CPU_COUNT(&set) == 0) {
+        free(cpus);
+        return NULL;
+    }
+    for (int i = 0; count < n; i = (i + 1) % CPU_SETSIZE)
+        if (CPU_ISSET((size_t)i, &set))
+            cpus[count++] = i;
+    return cpus;
+#else
+    (void)n;
+    return NULL;
+#endif
+}
+
+prng30_err prng30_wide_create(prng30_wide **out, uint64_t seed, int width, const prng30_wide_config *cfg) {
+    prng30_wide_config def;
+
+    if (!out)
+        return PRNG30_ERR_NULL;
+    *out = NULL;
+    if (width < PRNG30_MIN_WIDTH || width > PRNG30_WIDE_MAX_WIDTH)
+        return PRNG30_ERR_BADWIDTH;
+    if (!cfg) {
+        prng30_wide_default_config(&def);
+        cfg = &def;
+    }
+
+    prng30_wide *w = calloc(1, sizeof(*w));
+    if (!w)
+        return PRNG30_ERR_ALLOC;
+
+    w->width  = width;
+    w->nwords = PRNG30_WORDS(width);
+    w->halo   = (cfg->halo < 1) ? 1 : (cfg->halo > MAX_HALO) ? MAX_HALO : cfg->halo;
+    w->hwords = (w->halo + 63) / 64;
+
+    int threads = cfg->threads;
+    if (threads < 1)
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1)
+        threads = 1;
+    w->nthreads = (threads < w->nwords) ? threads : w->nwords;
+
+    int mid   = width / 2;
+    int tap   = width / 8;
+    w->tap[0] = mid;
+    w->tap[1] = (mid - tap + width) % width;
+    w->tap[2] = (mid + tap) % width;
+
+    w->out_cap = (size_t)JOB_EPOCHS * (size_t)w->halo;
+    for (int t = 0; t < 3; t++)
+        w->tapbits[t] = calloc(w->out_cap / 64 + 1, sizeof(uint64_t));
+
+    size_t bytes = (size_t)w->nwords * sizeof(uint64_t);
+    void  *r0 = NULL, *r1 = NULL;
+    if (posix_memalign(&r0, 4096, bytes) != 0)
+        r0 = NULL;
+    if (posix_memalign(&r1, 4096, bytes) != 0)
+        r1 = NULL;
+    w->row[0] = r0;
+    w->row[1] = r1;
+    w->parts  = calloc((size_t)w->nthreads, sizeof(struct part));
+
+    if (!w->row[0] || !w->row[1] || !w->parts || !w->tapbits[0] || !w->tapbits[1] || !w->tapbits[2]) {
+        prng30_wide_destroy(w);
+        return PRNG30_ERR_ALLOC;
+    }
+
+    int *cpus = cfg->pin ? allowed_cpus(w->nthreads) : NULL;
+    partition(w, cpus);
+    free(cpus);
+
+    pthread_mutex_init(&w->bar.lock, NULL);
+    pthread_cond_init(&w->bar.cond, NULL);
+    w->bar.count = w->nthreads;
+
+    prng30_err err = PRNG30_OK;
+    for (int i = 1; i < w->nthreads; i++) {
+        if (pthread_create(&w->parts[i].thread, NULL, helper, &w->parts[i]) != 0) {
+            // Shrink the barrier to the threads that did start so the
+            // init and shutdown waits below still complete.
+            pthread_mutex_lock(&w->bar.lock);
+            w->bar.count = w->nstarted + 1;
+            pthread_mutex_unlock(&w->bar.lock);
+            err = PRNG30_ERR_THREAD;
+            break;
+        }
+        w->nstarted++;
+    }
+
+    part_init(&w->parts[0]);
+    barrier_wait(&w->bar);
+
+    for (int i = 0; err == PRNG30_OK && i < w->nthreads; i++)
+        if (!w->parts[i].ok)
+            err = PRNG30_ERR_ALLOC;
+    if (err != PRNG30_OK) {
+        prng30_wide_destroy(w);
+        return err;
+    }
+
+    seed_wide(w, seed, (cfg->warmup < 0) ? (uint64_t)(width / 2) : (uint64_t)cfg->warmup);
+    *out = w;
+    return PRNG30_OK;
+}
+
+void prng30_wide_destroy(prng30_wide *w) {
+    if (!w)
+        return;
+    if (w->nstarted > 0) {
+        w->quit = 1;
+        barrier_wait(&w->bar);
+        for (int i = 1; i <= w->nstarted; i++)
+            pthread_join(w->parts[i].thread, NULL);
+    }
+    if (w->bar.count) {
+        pthread_mutex_destroy(&w->bar.lock);
+        pthread_cond_destroy(&w->bar.cond);
+    }
+    for (int i = 0; w->parts && i < w->nthreads; i++)
+        free(w->parts[i].scratch);
+    for (int t = 0; t < 3; t++)
+        free(w->tapbits[t]);
+    free(w->parts);
+    free(w->row[0]);
+    free(w->row[1]);
+    free(w);
+}
+
+int prng30_wide_threads(const prng30_wide *w) {
+    return w->nthreads;
+}
+
+void prng30_wide_step(prng30_wide *w, uint64_t generations) {
+    // Generations already computed for buffered output count first.
+    uint64_t have = w->out_len - w->out_pos;
+    uint64_t skip = (generations < have) ? generations : have;
+    w->out_pos += (size_t)skip;
+    run(w, generations - skip, 0);
+}
+
+uint64_t prng30_wide_generate(prng30_wide *w, int nbits) {
+    if (nbits <= 0)
+        return 0;
+    if (nbits > 64)
+        nbits = 64;
+
+    uint64_t out = 0;
+    for (int i = 0; i < nbits; i++)
+        out = (out << 1) | next_bit(w, (uint64_t)(nbits - i));
+    return out;
+}
+
+void prng30_wide_fill(prng30_wide *w, void *buf, size_t len) {
+    uint8_t *out = buf;
+
+    for (size_t i = 0; i < len; i++) {
+        unsigned byte = 0;
+        for (int b = 0; b < 8; b++)
+            byte = (byte << 1) | (unsigned)next_bit(w, 8 * (uint64_t)(len - i) - (uint64_t)b);
+        out[i] = (uint8_t)byte;
+    }
+}
+
+void prng30_wide_row(const prng30_wide *w, uint64_t *dst) {
+    memcpy(dst, w->row[w->cur], (size_t)w->nwords * sizeof(uint64_t));
+}
+
+void prng30_wide_set_row(prng30_wide *w, const uint64_t *src) {
+    uint64_t *row = w->row[w->cur];
+    memcpy(row, src, (size_t)w->nwords * sizeof(uint64_t));
+    row[w->nwords - 1] &= ~0ULL >> (63 - ((w->width - 1) & 63));
+    w->out_pos = w->out_len;
+}
@@ -28,5 +28,12 @@ static inline void check(const char *desc, int cond) {
 void run_core_tests(void);
 void run_statistical_tests(void);
 void run_double_tests(void);
+void run_ckpt_tests(void);
+void run_sample_tests(void);
+void run_hybrid_tests(void);
+void run_store_tests(void);
+void run_async_tests(void);
+void run_wide_tests(void);
+void run_serve_tests(void);
 
 #endif
\ No newline at end of file
@@ -10,6 +10,21 @@ int main(void) {
     run_core_tests();
     run_statistical_tests();
     run_double_tests();
+    run_ckpt_tests();
+    run_sample_tests();
+    run_hybrid_tests();
+#ifdef PRNG30_HAVE_STORE
+    run_store_tests();
+#endif
+#ifdef PRNG30_HAVE_ASYNC
+    run_async_tests();
+#endif
+#ifdef PRNG30_HAVE_WIDE
+    run_wide_tests();
+#endif
+#ifdef PRNG30_HAVE_SERVE
+    run_serve_tests();
+#endif
 
     printf("\n");
     printf("passed: %d\n", g_passed);
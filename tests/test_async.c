@@ -0,0 +1,86 @@
+#include "../include/prng30_async.h"
+#include "framework.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STREAM_BYTES 200000
+
+// Read STREAM_BYTES through an async generator in uneven pieces and compare
+// with the synchronous stream from the same seed.
+static int stream_matches(const prng30_async_config *cfg, uint64_t seed, int width) {
+    uint8_t     *want = malloc(STREAM_BYTES);
+    uint8_t     *got  = malloc(STREAM_BYTES);
+    prng30_state st;
+    int          ok = 0;
+
+    if (!want || !got)
+        goto done;
+
+    prng30_init(&st, seed, width);
+    prng30_fill(&st, want, STREAM_BYTES);
+    prng30_free(&st);
+
+    prng30_async *a;
+    prng30_init(&st, seed, width);
+    if (prng30_async_create(&a, &st, cfg) != PRNG30_OK)
+        goto done;
+
+    size_t pos = 0, piece = 1;
+    while (pos < STREAM_BYTES) {
+        size_t n = (piece < STREAM_BYTES - pos) ? piece : STREAM_BYTES - pos;
+        prng30_async_read(a, got + pos, n);
+        pos += n;
+        piece = (piece * 7 + 3) % 5000; // 1, 10, 73, 514, ... up to ~5 KB
+    }
+    prng30_async_destroy(a);
+
+    ok = memcmp(want, got, STREAM_BYTES) == 0;
+
+done:
+    free(want);
+    free(got);
+    return ok;
+}
+
+void run_async_tests(void) {
+    test_header("Async Generator (background refill)");
+
+    prng30_async_config cfg;
+
+    prng30_async_default_config(&cfg);
+    check("default config: stream identical to prng30_fill", stream_matches(&cfg, 12345, 64));
+    check("NULL config: stream identical to prng30_fill", stream_matches(NULL, 777, 128));
+
+    // A tiny ring forces constant wrap-around and underflow.
+    cfg.capacity   = 256;
+    cfg.low_water  = 64;
+    cfg.high_water = 192;
+    cfg.policy     = PRNG30_ASYNC_BLOCK;
+    check("small ring, blocking: stream identical", stream_matches(&cfg, 99, 64));
+
+    cfg.policy = PRNG30_ASYNC_FALLBACK;
+    check("small ring, inline fallback: stream identical", stream_matches(&cfg, 99, 64));
+
+    cfg.low_water = 0;
+    check("low watermark 0 does not stall", stream_matches(&cfg, 5, 32));
+
+    {
+        prng30_state  st;
+        prng30_async *a = NULL;
+        check("NULL state → PRNG30_ERR_NULL", prng30_async_create(&a, NULL, NULL) == PRNG30_ERR_NULL);
+
+        prng30_init(&st, 1, 64);
+        cfg.capacity = SIZE_MAX;
+        check("capacity past SIZE_MAX / 2 + 1 → PRNG30_ERR_RANGE, state kept",
+              prng30_async_create(&a, &st, &cfg) == PRNG30_ERR_RANGE && a == NULL && st.row != NULL);
+        check("create returns PRNG30_OK", prng30_async_create(&a, &st, NULL) == PRNG30_OK);
+        check("state ownership moved (caller copy zeroed)", st.row == NULL);
+        prng30_free(&st);
+        prng30_async_destroy(a);
+        prng30_async_destroy(NULL);
+        check("destroy without reading shuts down cleanly", 1);
+    }
+}
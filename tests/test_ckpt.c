@@ -0,0 +1,85 @@
+#include "../include/prng30_ckpt.h"
+#include "framework.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CKPT_PATH "prng30_test_ckpt.tmp"
+
+// Next 64 bits after seeking to `bit` must equal bits [bit, bit + 64) of
+// the stream generated from the start.
+static int seek_matches(prng30_ckpt *log, uint64_t bit, int width) {
+    prng30_state ref, st;
+
+    if (prng30_init(&ref, log->seed, width) != PRNG30_OK)
+        return 0;
+    for (uint64_t i = 0; i < bit; i++)
+        prng30_step(&ref);
+
+    if (prng30_ckpt_seek(log, &st, bit) != PRNG30_OK) {
+        prng30_free(&ref);
+        return 0;
+    }
+    int ok = prng30_generate(&st, 64) == prng30_generate(&ref, 64);
+    prng30_free(&st);
+    prng30_free(&ref);
+    return ok;
+}
+
+void run_ckpt_tests(void) {
+    test_header("Checkpoint Log (seek and verify)");
+
+    prng30_ckpt log;
+
+    check("interval 0 → PRNG30_ERR_RANGE", prng30_ckpt_create(CKPT_PATH, 0xC4EC, 100, 0, 10000) == PRNG30_ERR_RANGE);
+    check("create returns PRNG30_OK", prng30_ckpt_create(CKPT_PATH, 0xC4EC, 100, 1000, 10000) == PRNG30_OK);
+    check("open returns PRNG30_OK", prng30_ckpt_open(&log, CKPT_PATH) == PRNG30_OK);
+    check("header round-trips", log.width == 100 && log.seed == 0xC4EC && log.interval == 1000 && log.count == 10);
+
+    uint64_t bits[] = {0, 1, 999, 1000, 1001, 5555, 9999, 12345};
+    int      all    = 1;
+    for (int i = 0; i < 8; i++)
+        all &= seek_matches(&log, bits[i], 100);
+    check("seek to 8 offsets matches straight generation", all);
+
+    all = 1;
+    for (uint64_t i = 0; i < log.count; i++)
+        all &= prng30_ckpt_verify(&log, i) == PRNG30_OK;
+    check("every checkpoint verifies", all);
+    prng30_ckpt_close(&log);
+
+    // Flip one bit of the row stored in record 3.
+    FILE *f = fopen(CKPT_PATH, "r+b");
+    if (f) {
+        long off = 40 + 3 * (8 + 8 * PRNG30_WORDS(100)) + 8;
+        int  c;
+        fseek(f, off, SEEK_SET);
+        c = fgetc(f);
+        fseek(f, off, SEEK_SET);
+        fputc(c ^ 1, f);
+        fclose(f);
+    }
+    prng30_ckpt_open(&log, CKPT_PATH);
+    check("corrupted record → PRNG30_ERR_MISMATCH", prng30_ckpt_verify(&log, 3) == PRNG30_ERR_MISMATCH);
+    check("neighbouring record still verifies", prng30_ckpt_verify(&log, 2) == PRNG30_OK);
+    prng30_ckpt_close(&log);
+
+    // Truncate to the header alone.
+    f = fopen(CKPT_PATH, "r+b");
+    if (f) {
+        uint8_t hdr[40];
+        size_t  n = fread(hdr, 1, sizeof(hdr), f);
+        fclose(f);
+        f = fopen(CKPT_PATH, "wb");
+        if (f) {
+            fwrite(hdr, 1, n, f);
+            fclose(f);
+        }
+    }
+    check("truncated file → PRNG30_ERR_FORMAT", prng30_ckpt_open(&log, CKPT_PATH) == PRNG30_ERR_FORMAT);
+    prng30_ckpt_close(&log);
+    check("missing file → PRNG30_ERR_IO", prng30_ckpt_open(&log, "prng30_no_such_file.tmp") == PRNG30_ERR_IO);
+
+    remove(CKPT_PATH);
+}
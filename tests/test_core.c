@@ -3,6 +3,41 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+
+// Byte-per-cell Rule 30 step, the obvious form the packed kernel must match.
+static void reference_step(uint8_t *dst, const uint8_t *src, int n) {
+    for (int j = 0; j < n; j++)
+        dst[j] = src[(j - 1 + n) % n] ^ (src[j] | src[(j + 1) % n]);
+}
+
+static int packed_matches_reference(uint64_t seed, int width, int steps) {
+    prng30_state st;
+    uint8_t      cells[PRNG30_MAX_WIDTH], next[PRNG30_MAX_WIDTH];
+    int          ok = 1;
+
+    if (prng30_init(&st, seed, width) != PRNG30_OK)
+        return 0;
+    for (int i = 0; i < width; i++)
+        cells[i] = (uint8_t)prng30_cell(&st, i);
+
+    for (int s = 0; s < steps && ok; s++) {
+        reference_step(next, cells, width);
+        memcpy(cells, next, (size_t)width);
+        prng30_step(&st);
+        for (int i = 0; i < width; i++)
+            if (prng30_cell(&st, i) != cells[i]) {
+                ok = 0;
+                break;
+            }
+        // Padding bits past the last cell must stay clear.
+        if (width % 64 && st.row[st.nwords - 1] >> (width % 64))
+            ok = 0;
+    }
+
+    prng30_free(&st);
+    return ok;
+}
 
 void run_core_tests(void) {
     /* --- Initialisation and Memory Management --- */
@@ -12,6 +47,7 @@ void run_core_tests(void) {
         prng30_err   err = prng30_init(&st, 12345, 64);
         check("prng30_init returns PRNG30_OK", err == PRNG30_OK);
         check("width set correctly", st.width == 64);
+        check("nwords set correctly", st.nwords == PRNG30_WORDS(64));
         check("row buffer allocated", st.row != NULL);
         check("next_row buffer allocated", st.next_row != NULL);
         prng30_free(&st);
@@ -20,6 +56,86 @@ void run_core_tests(void) {
         check("width zeroed after free", st.width == 0);
     }
 
+    /* --- Packed Step --- */
+    test_header("Packed Step (matches byte-per-cell Rule 30)");
+    {
+        int  widths[] = {32, 33, 63, 64, 65, 127, 128, 129, 1000, PRNG30_MAX_WIDTH};
+        char msg[64];
+        for (int i = 0; i < 10; i++) {
+            snprintf(msg, sizeof(msg), "width=%d: 300 steps identical", widths[i]);
+            check(msg, packed_matches_reference(0xC0FFEE + (uint64_t)i, widths[i], 300));
+        }
+
+        prng30_state a, b;
+        prng30_init(&a, 4242, 200);
+        prng30_init(&b, 4242, 200);
+        prng30_step(&a);
+        prng30_step_packed(b.next_row, b.row, b.width);
+        check("prng30_step_packed agrees with prng30_step",
+              memcmp(a.row, b.next_row, (size_t)a.nwords * sizeof(uint64_t)) == 0);
+        prng30_free(&a);
+        prng30_free(&b);
+    }
+
+    /* --- Bulk Fill --- */
+    test_header("Bulk Fill (prng30_fill matches prng30_generate)");
+    {
+        prng30_state a, b;
+        uint8_t      buf[257];
+        int          match = 1;
+        prng30_init(&a, 31337, 100);
+        prng30_init(&b, 31337, 100);
+        prng30_fill(&a, buf, 1);
+        prng30_fill(&a, buf + 1, sizeof(buf) - 1);
+        for (size_t i = 0; i < sizeof(buf); i++)
+            if (buf[i] != (uint8_t)prng30_generate(&b, 8)) {
+                match = 0;
+                break;
+            }
+        check("257 bytes equal successive 8-bit draws", match);
+        check("states agree afterwards", prng30_generate(&a, 64) == prng30_generate(&b, 64));
+        prng30_free(&a);
+        prng30_free(&b);
+
+        // Rows of one word take a separate path.
+        match = 1;
+        for (int w = PRNG30_MIN_WIDTH; w <= 64; w++) {
+            prng30_init(&a, 31337, w);
+            prng30_init(&b, 31337, w);
+            prng30_fill(&a, buf, 100);
+            for (size_t i = 0; i < 100; i++)
+                match &= buf[i] == (uint8_t)prng30_generate(&b, 8);
+            match &= prng30_generate(&a, 64) == prng30_generate(&b, 64);
+            prng30_free(&a);
+            prng30_free(&b);
+        }
+        check("widths 32..64 (one-word rows) also match", match);
+    }
+
+    /* --- Counter-Based Blocks --- */
+    test_header("Counter-Based Blocks (prng30_block)");
+    {
+        uint8_t      blk[64], ref[64], other[64];
+        prng30_state st;
+
+        check("prng30_block returns PRNG30_OK", prng30_block(2024, 128, 1000000007ULL, blk, sizeof(blk)) == PRNG30_OK);
+        prng30_init(&st, prng30_block_seed(2024, 1000000007ULL), 128);
+        prng30_fill(&st, ref, sizeof(ref));
+        prng30_free(&st);
+        check("block equals init(block_seed) + fill", memcmp(blk, ref, sizeof(blk)) == 0);
+
+        prng30_block(2024, 128, 1000000007ULL, ref, 16);
+        check("shorter read is a prefix of the block", memcmp(blk, ref, 16) == 0);
+
+        prng30_block(2024, 128, 1000000008ULL, other, sizeof(other));
+        check("adjacent indices give different blocks", memcmp(blk, other, sizeof(blk)) != 0);
+        prng30_block(2025, 128, 1000000007ULL, other, sizeof(other));
+        check("different seeds give different blocks", memcmp(blk, other, sizeof(blk)) != 0);
+
+        check("NULL buffer → PRNG30_ERR_NULL", prng30_block(1, 64, 0, NULL, 8) == PRNG30_ERR_NULL);
+        check("bad width → PRNG30_ERR_BADWIDTH", prng30_block(1, PRNG30_MAX_WIDTH + 1, 0, blk, 8) == PRNG30_ERR_BADWIDTH);
+    }
+
     /* --- Determinism --- */
     test_header("Determinism (same seed → same sequence)");
     {
@@ -0,0 +1,110 @@
+#include "../include/prng30.h"
+#include "framework.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// After `before` bits, jumping n must leave the state where generating and
+// discarding n bits would.
+static int jump_matches(uint64_t seed, int width, uint64_t before, uint64_t n) {
+    prng30_state a, b;
+
+    prng30_init_hybrid(&a, seed, width);
+    prng30_init_hybrid(&b, seed, width);
+    for (uint64_t i = 0; i < before; i++) {
+        prng30_generate(&a, 1);
+        prng30_generate(&b, 1);
+    }
+
+    int ok = prng30_jump(&a, n) == PRNG30_OK;
+    for (uint64_t i = 0; i < n; i++)
+        prng30_generate(&b, 1);
+    ok &= prng30_generate(&a, 64) == prng30_generate(&b, 64);
+
+    prng30_free(&a);
+    prng30_free(&b);
+    return ok;
+}
+
+void run_hybrid_tests(void) {
+    test_header("Hybrid Mode (Rule 30 + Rule 90/150, jump-ahead)");
+
+    {
+        prng30_state a, b, p;
+        check("init_hybrid returns PRNG30_OK", prng30_init_hybrid(&a, 42, 64) == PRNG30_OK);
+        check("mode is PRNG30_MODE_HYBRID", a.mode == PRNG30_MODE_HYBRID);
+        prng30_init_hybrid(&b, 42, 64);
+        prng30_init(&p, 42, 64);
+
+        int same = 1, differs = 0;
+        for (int i = 0; i < 100; i++) {
+            uint64_t x = prng30_generate(&a, 64);
+            same &= x == prng30_generate(&b, 64);
+            differs |= x != prng30_generate(&p, 64);
+        }
+        check("same seed → same sequence", same);
+        check("stream differs from plain mode", differs);
+
+        uint8_t buf[64];
+        int     fill_ok = 1;
+        prng30_fill(&a, buf, sizeof(buf));
+        for (size_t i = 0; i < sizeof(buf); i++)
+            fill_ok &= buf[i] == (uint8_t)prng30_generate(&b, 8);
+        check("prng30_fill matches prng30_generate(8)", fill_ok);
+
+        check("plain-mode jump → PRNG30_ERR_MODE", prng30_jump(&p, 10) == PRNG30_ERR_MODE);
+        check("NULL state → PRNG30_ERR_NULL", prng30_jump(NULL, 10) == PRNG30_ERR_NULL);
+        prng30_free(&a);
+        prng30_free(&b);
+        prng30_free(&p);
+
+        check("width 31 → PRNG30_ERR_BADWIDTH", prng30_init_hybrid(&a, 1, 31) == PRNG30_ERR_BADWIDTH);
+    }
+
+    check("jump 0 and 1", jump_matches(1, 64, 0, 0) && jump_matches(1, 64, 0, 1));
+    check("jump inside one block", jump_matches(2, 96, 1234, 5000));
+    check("jump to exactly the next block", jump_matches(3, 64, 0, PRNG30_HYBRID_BLOCK));
+    check("jump ending on a block boundary from mid-block", jump_matches(4, 64, 40000, PRNG30_HYBRID_BLOCK - 40000));
+    check("jump across several blocks", jump_matches(5, 128, 40000, 3 * PRNG30_HYBRID_BLOCK + 777));
+
+    {
+        // Jumps compose: (a then b) = (a + b), far beyond anything steppable.
+        prng30_state x, y;
+        uint64_t     a = 1000000000000ULL, b = 1000000000000007ULL;
+        prng30_init_hybrid(&x, 9, 256);
+        prng30_init_hybrid(&y, 9, 256);
+        prng30_jump(&x, a);
+        prng30_jump(&x, b);
+        prng30_jump(&y, a + b);
+        check("jump(a) then jump(b) = jump(a + b) for a, b ≈ 10^12, 10^15",
+              x.pos == a + b && prng30_generate(&x, 64) == prng30_generate(&y, 64));
+        prng30_free(&x);
+        prng30_free(&y);
+    }
+
+    {
+        prng30_state st;
+        const int    n    = 1000000;
+        int          ones = 0, counts[256] = {0};
+        prng30_init_hybrid(&st, 2024, 64);
+        for (int i = 0; i < n / 64; i++) {
+            uint64_t v = prng30_generate(&st, 64);
+            for (int k = 0; k < 64; k += 8)
+                counts[(v >> k) & 0xFF]++;
+            while (v) {
+                v &= v - 1;
+                ones++;
+            }
+        }
+        double z    = fabs((double)ones - n / 2.0) / sqrt(n / 4.0);
+        double chi2 = 0.0, e = (double)(n / 64 * 8) / 256.0;
+        for (int i = 0; i < 256; i++)
+            chi2 += ((double)counts[i] - e) * ((double)counts[i] - e) / e;
+        printf("  monobit z=%.2f  byte χ²=%.1f  (critical values 2.576, 310.5 at α=0.01)\n", z, chi2);
+        check("monobit |z| < 2.576 across block reseeds", z < 2.576);
+        check("byte χ² < 310.5", chi2 < 310.5);
+        prng30_free(&st);
+    }
+}
@@ -0,0 +1,171 @@
+#include "../include/prng30.h"
+#include "framework.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int is_permutation(const uint32_t *a, size_t n) {
+    uint8_t *seen = calloc(n, 1);
+    int      ok   = seen != NULL;
+    for (size_t i = 0; ok && i < n; i++) {
+        if (a[i] >= n || seen[a[i]])
+            ok = 0;
+        else
+            seen[a[i]] = 1;
+    }
+    free(seen);
+    return ok;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+void run_sample_tests(void) {
+    /* --- Uniform --- */
+    test_header("Bounded Uniform Integers (prng30_uniform)");
+    {
+        prng30_state st;
+        prng30_init(&st, 606, 64);
+        int in_range = 1, counts[6] = {0};
+        for (int i = 0; i < 6000; i++) {
+            uint64_t v = prng30_uniform(&st, 6);
+            if (v >= 6)
+                in_range = 0;
+            else
+                counts[v]++;
+        }
+        double chi2 = 0.0;
+        for (int i = 0; i < 6; i++)
+            chi2 += (counts[i] - 1000.0) * (counts[i] - 1000.0) / 1000.0;
+        printf("  χ²=%.2f  (χ²(5df) critical value at α=0.01: 15.09)\n", chi2);
+        check("all values in [0, 6)", in_range);
+        check("χ² < 15.09", chi2 < 15.09);
+        check("bound 1 → 0", prng30_uniform(&st, 1) == 0);
+        prng30_free(&st);
+    }
+
+    /* --- Shuffle --- */
+    test_header("Shuffle (prng30_shuffle)");
+    {
+        const size_t n = 10007;
+        uint32_t    *a = malloc(n * sizeof(uint32_t));
+        uint32_t    *b = malloc(n * sizeof(uint32_t));
+        prng30_state s1, s2;
+
+        if (a && b) {
+            for (size_t i = 0; i < n; i++)
+                a[i] = b[i] = (uint32_t)i;
+            prng30_init(&s1, 42, 64);
+            prng30_init(&s2, 42, 64);
+            prng30_shuffle(&s1, a, n, sizeof(uint32_t));
+            prng30_shuffle(&s2, b, n, sizeof(uint32_t));
+
+            size_t fixed = 0;
+            for (size_t i = 0; i < n; i++)
+                fixed += a[i] == i;
+            check("result is a permutation", is_permutation(a, n));
+            check("same seed → same permutation", memcmp(a, b, n * sizeof(uint32_t)) == 0);
+            check("few fixed points (expected ≈ 1)", fixed < 10);
+            prng30_free(&s1);
+            prng30_free(&s2);
+        }
+        free(a);
+        free(b);
+
+        // All 6 orderings of 3 elements of an odd size, roughly equally often.
+        struct {
+            char c[3];
+        } e[3];
+        int          perms[6] = {0};
+        prng30_state st;
+        prng30_init(&st, 7, 64);
+        for (int t = 0; t < 6000; t++) {
+            for (int i = 0; i < 3; i++)
+                memset(e[i].c, 'a' + i, 3);
+            prng30_shuffle(&st, e, 3, sizeof(e[0]));
+            int p = (e[0].c[0] - 'a') * 2 + (e[1].c[0] > e[2].c[0]);
+            perms[p]++;
+        }
+        double chi2 = 0.0;
+        for (int i = 0; i < 6; i++)
+            chi2 += (perms[i] - 1000.0) * (perms[i] - 1000.0) / 1000.0;
+        printf("  χ²=%.2f over 6 orderings  (critical value at α=0.01: 15.09)\n", chi2);
+        check("3-element shuffle uniform over orderings", chi2 < 15.09);
+        prng30_free(&st);
+    }
+
+    /* --- Floyd sampling --- */
+    test_header("Sampling Without Replacement (prng30_sample)");
+    {
+        prng30_state st;
+        uint64_t     out[500];
+        prng30_init(&st, 11, 64);
+
+        check("k=500 from n=10^12 returns PRNG30_OK", prng30_sample(&st, 1000000000000ULL, 500, out) == PRNG30_OK);
+        qsort(out, 500, sizeof(uint64_t), cmp_u64);
+        int distinct = 1, in_range = 1;
+        for (int i = 0; i < 500; i++) {
+            if (i > 0 && out[i] == out[i - 1])
+                distinct = 0;
+            if (out[i] >= 1000000000000ULL)
+                in_range = 0;
+        }
+        check("values distinct", distinct);
+        check("values in [0, n)", in_range);
+
+        check("k = n returns every value", prng30_sample(&st, 100, 100, out) == PRNG30_OK);
+        qsort(out, 100, sizeof(uint64_t), cmp_u64);
+        int all = 1;
+        for (uint64_t i = 0; i < 100; i++)
+            all &= out[i] == i;
+        check("k = n covers [0, n) exactly", all);
+        check("k > n → PRNG30_ERR_RANGE", prng30_sample(&st, 5, 6, out) == PRNG30_ERR_RANGE);
+        prng30_free(&st);
+    }
+
+    /* --- Reservoir sampling --- */
+    test_header("Reservoir Sampling (prng30_reservoir)");
+    {
+        const size_t n = 100000, k = 100;
+        uint64_t    *src = malloc(n * sizeof(uint64_t));
+        uint64_t     dst[100];
+        prng30_state st;
+        prng30_init(&st, 12, 64);
+
+        if (src) {
+            for (size_t i = 0; i < n; i++)
+                src[i] = i;
+            check("returns PRNG30_OK", prng30_reservoir(&st, src, n, sizeof(uint64_t), dst, k) == PRNG30_OK);
+            qsort(dst, k, sizeof(uint64_t), cmp_u64);
+            int    distinct = 1;
+            double mean     = 0.0;
+            for (size_t i = 0; i < k; i++) {
+                if (i > 0 && dst[i] == dst[i - 1])
+                    distinct = 0;
+                mean += (double)dst[i] / (double)k;
+            }
+            printf("  mean index=%.0f  (expected ≈ %.0f)\n", mean, (double)(n - 1) / 2.0);
+            check("elements distinct", distinct);
+            check("mean index within 20% of n/2", mean > 0.4 * (double)n && mean < 0.6 * (double)n);
+
+            // Over many trials each element should be picked about k/n of the time.
+            int hits_first = 0, hits_last = 0;
+            for (int t = 0; t < 2000; t++) {
+                prng30_reservoir(&st, src, 1000, sizeof(uint64_t), dst, 10);
+                for (int i = 0; i < 10; i++) {
+                    hits_first += dst[i] < 100;
+                    hits_last += dst[i] >= 900;
+                }
+            }
+            printf("  first 10%% picked %d, last 10%% picked %d  (expected ≈ 2000 each)\n", hits_first, hits_last);
+            check("no bias toward early or late elements", hits_first > 1800 && hits_first < 2200 && hits_last > 1800 && hits_last < 2200);
+        }
+        check("k > n → PRNG30_ERR_RANGE", prng30_reservoir(&st, dst, 5, sizeof(uint64_t), dst, 6) == PRNG30_ERR_RANGE);
+        free(src);
+        prng30_free(&st);
+    }
+}
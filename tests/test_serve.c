@@ -0,0 +1,172 @@
+#include "../include/prng30_serve.h"
+#include "framework.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define SOCK_PATH "prng30_test_serve.sock"
+#define NCLIENTS 40
+
+static void *serve_thread(void *arg) {
+    prng30_server_run(arg);
+    return NULL;
+}
+
+// With only one client of a width, it receives that width's whole stream,
+// reserve included, in order.
+static int stream_matches(int width, size_t len) {
+    prng30_client *c;
+    prng30_state   st;
+    uint8_t       *got  = malloc(len);
+    uint8_t       *want = malloc(len);
+    int            ok   = got && want && prng30_client_connect(&c, SOCK_PATH, width) == PRNG30_OK;
+
+    if (ok) {
+        prng30_init(&st, 7, width);
+        prng30_fill(&st, want, len);
+        // Uneven pieces, so both the local buffer and direct requests are used.
+        size_t off = 0;
+        for (size_t step = 1; off < len; step = step * 3 + 1) {
+            size_t n = (step < len - off) ? step : len - off;
+            ok &= prng30_client_fill(c, got + off, n) == PRNG30_OK;
+            off += n;
+        }
+        ok &= memcmp(got, want, len) == 0;
+        prng30_free(&st);
+        prng30_client_close(c);
+    }
+    free(got);
+    free(want);
+    return ok;
+}
+
+// Interleaved generate and fill calls that end mid-byte read the same bit
+// stream as the same calls on a local generator.
+static int mixed_calls_match(int width) {
+    static const int sizes[] = {3, 5, 13, 5000, 64, 1, 7, 9};
+    prng30_client   *c;
+    prng30_state     st;
+    uint8_t          got[5000], want[5000];
+    int              ok = prng30_client_connect(&c, SOCK_PATH, width) == PRNG30_OK;
+
+    if (ok) {
+        prng30_init(&st, 7, width);
+        for (int i = 0; i < 8; i++) {
+            if (i % 2 == 0)
+                ok &= prng30_client_generate(c, sizes[i]) == prng30_generate(&st, sizes[i]);
+            else {
+                ok &= prng30_client_fill(c, got, (size_t)sizes[i]) == PRNG30_OK;
+                prng30_fill(&st, want, (size_t)sizes[i]);
+                ok &= memcmp(got, want, (size_t)sizes[i]) == 0;
+            }
+        }
+        prng30_free(&st);
+        prng30_client_close(c);
+    }
+    return ok;
+}
+
+void run_serve_tests(void) {
+    test_header("Local Random-Byte Server (Unix socket)");
+
+    prng30_server_config cfg;
+    prng30_server       *srv;
+    pthread_t            thread;
+
+    prng30_server_default_config(&cfg);
+    cfg.seed       = 7;
+    cfg.max_widths = 4;
+
+    FILE *f = fopen(SOCK_PATH, "w");
+    if (f)
+        fclose(f);
+    check("regular file at the path → PRNG30_ERR_IO, file kept",
+          f && prng30_server_create(&srv, SOCK_PATH, &cfg) == PRNG30_ERR_IO && access(SOCK_PATH, F_OK) == 0);
+    remove(SOCK_PATH);
+
+    size_t reserve = cfg.reserve;
+    cfg.reserve    = SIZE_MAX;
+    check("reserve past SIZE_MAX / 2 + 1 → PRNG30_ERR_RANGE", prng30_server_create(&srv, SOCK_PATH, &cfg) == PRNG30_ERR_RANGE);
+    cfg.reserve = reserve;
+
+    // A socket file nobody listens on, as a crashed server leaves behind.
+    {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strcpy(addr.sun_path, SOCK_PATH);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0) {
+            check("stale socket file set up", bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+            close(fd);
+        }
+    }
+
+    if (prng30_server_create(&srv, SOCK_PATH, &cfg) != PRNG30_OK || pthread_create(&thread, NULL, serve_thread, srv) != 0) {
+        check("server starts", 0);
+        return;
+    }
+    check("server starts", 1);
+
+    {
+        prng30_server *second;
+        check("second server on a live socket → PRNG30_ERR_IO", prng30_server_create(&second, SOCK_PATH, &cfg) == PRNG30_ERR_IO);
+    }
+
+    check("lone client gets prng30_init(seed, 64) stream, 3 MB", stream_matches(64, 3u << 20));
+    check("width 96 has its own stream", stream_matches(96, 10000));
+    check("mixed generate and fill continue one bit stream", mixed_calls_match(160));
+
+    {
+        prng30_client *c[NCLIENTS];
+        uint64_t       first[NCLIENTS];
+        int            ok = 1, distinct = 1;
+        for (int i = 0; i < NCLIENTS; i++)
+            ok &= prng30_client_connect(&c[i], SOCK_PATH, 128) == PRNG30_OK;
+        check("40 clients connect", ok);
+
+        // Interleaved so every connection has requests outstanding in turn.
+        for (int round = 0; round < 50 && ok; round++)
+            for (int i = 0; i < NCLIENTS; i++) {
+                first[i] = prng30_client_generate(c[i], 64);
+                ok &= prng30_client_status(c[i]) == PRNG30_OK;
+                uint8_t big[5000];
+                ok &= prng30_client_fill(c[i], big, sizeof(big)) == PRNG30_OK;
+            }
+        for (int i = 0; i < NCLIENTS; i++)
+            for (int j = 0; j < i; j++)
+                distinct &= first[i] != first[j];
+        check("interleaved generate and fill on all of them", ok);
+        check("clients of one width get disjoint bytes", distinct);
+        for (int i = 0; i < NCLIENTS; i++)
+            prng30_client_close(c[i]);
+    }
+
+    {
+        prng30_client *c;
+        uint8_t        buf[16];
+        check("bad width → PRNG30_ERR_BADWIDTH", prng30_client_connect(&c, SOCK_PATH, 31) == PRNG30_ERR_BADWIDTH);
+        check("no server → PRNG30_ERR_IO", prng30_client_connect(&c, "prng30_no_such.sock", 64) == PRNG30_ERR_IO);
+
+        // 64, 96, 128 and 160 are served; a fifth width is refused.
+        check("width past max_widths → PRNG30_ERR_IO",
+              prng30_client_connect(&c, SOCK_PATH, 200) == PRNG30_OK && prng30_client_fill(c, buf, sizeof(buf)) == PRNG30_ERR_IO &&
+                  prng30_client_generate(c, 8) == 0);
+        prng30_client_close(c);
+
+        check("connect before stop", prng30_client_connect(&c, SOCK_PATH, 64) == PRNG30_OK);
+        prng30_server_stop(srv);
+        pthread_join(thread, NULL);
+        prng30_server_destroy(srv);
+        check("fill after the server is gone → PRNG30_ERR_IO",
+              prng30_client_fill(c, buf, sizeof(buf)) == PRNG30_ERR_IO && prng30_client_status(c) == PRNG30_ERR_IO);
+        prng30_client_close(c);
+        check("socket file removed", access(SOCK_PATH, F_OK) != 0);
+    }
+}
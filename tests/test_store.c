@@ -0,0 +1,102 @@
+#include "../include/prng30_store.h"
+#include "framework.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define STORE_PATH "prng30_test_store.tmp"
+#define NSLOTS 20000
+
+static uint64_t seed_of(uint64_t id) {
+    return id * 0x9E3779B97F4A7C15ULL + 1;
+}
+
+// Slot id, after `used` bytes were drawn from it, must continue the stream
+// of a prng30_state with the same seed.
+static int slot_matches(prng30_store *s, uint64_t id, int width, size_t used) {
+    prng30_state st;
+    uint8_t      want[300], got[300];
+
+    prng30_init(&st, seed_of(id), width);
+    prng30_fill(&st, want, used);
+    prng30_fill(&st, want, sizeof(want));
+    uint64_t next = prng30_generate(&st, 37);
+    prng30_free(&st);
+
+    prng30_store_fill(s, id, got, sizeof(got));
+    return memcmp(want, got, sizeof(want)) == 0 && prng30_store_generate(s, id, 37) == next;
+}
+
+void run_store_tests(void) {
+    test_header("Memory-Mapped State Store");
+
+    prng30_store s;
+    uint8_t      buf[64];
+    int          all;
+
+    check("create returns PRNG30_OK", prng30_store_create(&s, STORE_PATH, 96, NSLOTS) == PRNG30_OK);
+    check("96-cell slots use a 16-byte stride", s.stride == 16);
+
+    all = 1;
+    for (uint64_t id = 0; id < NSLOTS; id++)
+        all &= prng30_store_seed(&s, id, seed_of(id)) == PRNG30_OK;
+    check("seed every slot", all);
+
+    // Draw an uneven amount from a few slots before closing.
+    for (uint64_t id = 0; id < NSLOTS; id += 997)
+        prng30_store_fill(&s, id, buf, (size_t)(id % 61));
+    check("slot stream identical to prng30_state", slot_matches(&s, 5, 96, 0));
+
+    size_t dirty = prng30_store_dirty_pages(&s);
+    check("flush of 2 pages leaves the rest dirty", prng30_store_flush(&s, 2) == PRNG30_OK && prng30_store_dirty_pages(&s) == dirty - 2);
+    check("full flush clears every page", prng30_store_flush(&s, 0) == PRNG30_OK && prng30_store_dirty_pages(&s) == 0);
+    prng30_store_generate(&s, 3, 8);
+    check("one generate dirties one page", prng30_store_dirty_pages(&s) == 1);
+    prng30_store_close(&s);
+
+    check("reopen returns PRNG30_OK", prng30_store_open(&s, STORE_PATH) == PRNG30_OK);
+    check("header round-trips", s.width == 96 && s.count == NSLOTS);
+    all = 1;
+    for (uint64_t id = 997; id < NSLOTS; id += 997)
+        all &= slot_matches(&s, id, 96, (size_t)(id % 61));
+    check("streams continue across close and reopen", all);
+
+    {
+        prng30_state st, ref;
+        prng30_init(&ref, seed_of(42), 96);
+        check("load returns PRNG30_OK", prng30_store_load(&s, 42, &st) == PRNG30_OK);
+        check("loaded state continues the stream", prng30_generate(&st, 64) == prng30_generate(&ref, 64));
+        check("save returns PRNG30_OK", prng30_store_save(&s, 42, &st) == PRNG30_OK);
+        check("saved slot continues the stream", prng30_store_generate(&s, 42, 64) == prng30_generate(&ref, 64));
+        prng30_free(&st);
+        prng30_free(&ref);
+
+        prng30_init(&st, 1, 128);
+        check("save of another width → PRNG30_ERR_BADWIDTH", prng30_store_save(&s, 0, &st) == PRNG30_ERR_BADWIDTH);
+        check("id past the end → PRNG30_ERR_RANGE", prng30_store_save(&s, NSLOTS, &st) == PRNG30_ERR_RANGE);
+        prng30_free(&st);
+    }
+    prng30_store_close(&s);
+    prng30_store_close(&s);
+
+    check("4096-cell slots use whole cache lines",
+          prng30_store_create(&s, STORE_PATH, 4096, 3) == PRNG30_OK && s.stride == 512 &&
+              prng30_store_seed(&s, 2, seed_of(2)) == PRNG30_OK && slot_matches(&s, 2, 4096, 0));
+    prng30_store_close(&s);
+
+    check("count 0 → PRNG30_ERR_RANGE", prng30_store_create(&s, STORE_PATH, 64, 0) == PRNG30_ERR_RANGE);
+    check("width 31 → PRNG30_ERR_BADWIDTH", prng30_store_create(&s, STORE_PATH, 31, 10) == PRNG30_ERR_BADWIDTH);
+
+    // Truncate to the header alone.
+    FILE *f = fopen(STORE_PATH, "wb");
+    if (f) {
+        fwrite("PRNG30ST\1\0\0\0\100\0\0\0\12", 1, 17, f);
+        fclose(f);
+    }
+    check("truncated file → PRNG30_ERR_FORMAT", prng30_store_open(&s, STORE_PATH) == PRNG30_ERR_FORMAT);
+    check("missing file → PRNG30_ERR_IO", prng30_store_open(&s, "prng30_no_such_file.tmp") == PRNG30_ERR_IO);
+    prng30_store_close(&s);
+
+    remove(STORE_PATH);
+}
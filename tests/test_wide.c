@@ -0,0 +1,128 @@
+#include "../include/prng30_wide.h"
+#include "framework.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STREAM_BYTES 1500
+
+// Same seed and width through prng30_state and prng30_wide, mixing
+// generate, step and fill, must give the same bits.
+static int stream_matches(uint64_t seed, int width, int threads, int halo) {
+    uint8_t            want[STREAM_BYTES], got[STREAM_BYTES];
+    prng30_state       st;
+    prng30_wide       *w;
+    prng30_wide_config cfg;
+
+    prng30_wide_default_config(&cfg);
+    cfg.threads = threads;
+    cfg.halo    = halo;
+    if (prng30_wide_create(&w, seed, width, &cfg) != PRNG30_OK)
+        return 0;
+    prng30_init(&st, seed, width);
+
+    int ok = prng30_generate(&st, 17) == prng30_wide_generate(w, 17);
+    for (int i = 0; i < 200; i++)
+        prng30_step(&st);
+    prng30_wide_step(w, 200);
+    ok &= prng30_generate(&st, 64) == prng30_wide_generate(w, 64);
+
+    prng30_fill(&st, want, STREAM_BYTES);
+    prng30_wide_fill(w, got, 333);
+    prng30_wide_fill(w, got + 333, STREAM_BYTES - 333);
+    ok &= memcmp(want, got, STREAM_BYTES) == 0;
+
+    prng30_wide_destroy(w);
+    prng30_free(&st);
+    return ok;
+}
+
+// Stepping an arbitrary row of a width beyond PRNG30_MAX_WIDTH must match
+// prng30_step_packed generation for generation.
+static int rows_match(int width, int threads, int halo, int gens) {
+    int                nw  = PRNG30_WORDS(width);
+    uint64_t          *a   = malloc((size_t)nw * sizeof(uint64_t));
+    uint64_t          *b   = malloc((size_t)nw * sizeof(uint64_t));
+    uint64_t          *got = malloc((size_t)nw * sizeof(uint64_t));
+    prng30_wide       *w   = NULL;
+    prng30_wide_config cfg;
+    int                ok = 0;
+
+    prng30_wide_default_config(&cfg);
+    cfg.threads = threads;
+    cfg.halo    = halo;
+    cfg.warmup  = 0;
+    if (!a || !b || !got || prng30_wide_create(&w, 1, width, &cfg) != PRNG30_OK)
+        goto done;
+
+    uint64_t x = 0x5EED;
+    for (int i = 0; i < nw; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        a[i] = x;
+    }
+    if (width & 63)
+        a[nw - 1] &= ~0ULL >> (64 - (width & 63));
+    prng30_wide_set_row(w, a);
+
+    ok = 1;
+    for (int done = 0, chunk = 1; done < gens; done += chunk, chunk = chunk * 3 + 1) {
+        if (chunk > gens - done)
+            chunk = gens - done;
+        for (int g = 0; g < chunk; g++) {
+            prng30_step_packed(b, a, width);
+            uint64_t *t = a;
+            a           = b;
+            b           = t;
+        }
+        prng30_wide_step(w, (uint64_t)chunk);
+        prng30_wide_row(w, got);
+        ok &= memcmp(a, got, (size_t)nw * sizeof(uint64_t)) == 0;
+    }
+
+done:
+    prng30_wide_destroy(w);
+    free(a);
+    free(b);
+    free(got);
+    return ok;
+}
+
+void run_wide_tests(void) {
+    test_header("Wide Automaton (multi-threaded stepping)");
+
+    static const int widths[] = {32, 64, 100, 257, 1000, 4096};
+    int              all      = 1;
+    for (int i = 0; i < 6; i++) {
+        all &= stream_matches(0xA11CE + (uint64_t)i, widths[i], 1, 64);
+        all &= stream_matches(0xA11CE + (uint64_t)i, widths[i], 3, 100);
+    }
+    check("stream identical to prng30_state, widths 32-4096", all);
+    check("halo 1 (barrier every generation): stream identical", stream_matches(7, 640, 4, 1));
+    check("halo wider than the row: stream identical", stream_matches(7, 96, 2, 700));
+
+    check("100 003 cells, 4 threads: rows match prng30_step_packed", rows_match(100003, 4, 96, 1500));
+    check("100 003 cells, 1 thread: rows match prng30_step_packed", rows_match(100003, 1, 512, 600));
+    check("tiles and halos across slice edges: rows match", rows_match(3 * 64 * 2048 + 77, 3, 130, 400));
+
+    {
+        prng30_wide       *w = NULL;
+        prng30_wide_config cfg;
+        prng30_wide_default_config(&cfg);
+        cfg.threads = 8;
+
+        check("width 31 → PRNG30_ERR_BADWIDTH", prng30_wide_create(&w, 1, 31, &cfg) == PRNG30_ERR_BADWIDTH);
+        check("width above PRNG30_WIDE_MAX_WIDTH → PRNG30_ERR_BADWIDTH",
+              prng30_wide_create(&w, 1, PRNG30_WIDE_MAX_WIDTH + 1, &cfg) == PRNG30_ERR_BADWIDTH);
+        check("NULL out → PRNG30_ERR_NULL", prng30_wide_create(NULL, 1, 64, &cfg) == PRNG30_ERR_NULL);
+
+        check("NULL config returns PRNG30_OK", prng30_wide_create(&w, 1, 128, NULL) == PRNG30_OK);
+        prng30_wide_destroy(w);
+        check("threads capped at one per row word", prng30_wide_create(&w, 1, 130, &cfg) == PRNG30_OK && prng30_wide_threads(w) == 3);
+        prng30_wide_destroy(w);
+        prng30_wide_destroy(NULL);
+    }
+}
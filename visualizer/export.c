@@ -0,0 +1,340 @@
+#include "../include/prng30.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//  Headless space-time diagram export. Streams one scanline per generation
+//  straight from the bit-packed rows, so the cost per row is one CA step
+//  plus a byte-wise bit reversal; no per-pixel work is done for PBM.
+
+//  Usage:
+//    ./prng30_export [options] <output> [seed] [width] [generations]
+
+//    output      : file name; .pgm selects PGM, anything else PBM
+//    seed        : def: time-based
+//    width       : automaton width (def: 64)
+//    generations : rows to export (def: 1000)
+
+//  Options:
+//    --scale N   : PGM only; each pixel is the live fraction of an N x N
+//                  block of cells (def: 4)
+//    --tile N    : split into files of N generations each, named
+//                  <output>_00000.<ext>, <output>_00001.<ext>, ...
+//    --mark      : prepend a ruler to each image marking the three columns
+//                  read by prng30_generate (centre and centre +- width/8)
+
+//  Example:
+//    ./prng30_export rule30.pbm 12345 4096 1000000
+//    ./prng30_export --scale 8 --tile 100000 --mark rule30.pgm 12345 4096 10000000
+
+#define RULER_ROWS 4
+
+enum { FMT_PBM, FMT_PGM };
+
+typedef struct {
+    int         format;
+    int         scale;
+    uint64_t    tile;
+    int         mark;
+    int         width;
+    int         taps[3];
+    const char *path;
+} export_opts;
+
+static uint8_t reverse8[256];
+
+static void init_reverse8(void) {
+    for (int i = 0; i < 256; i++) {
+        uint8_t r = 0;
+        for (int b = 0; b < 8; b++)
+            if (i & (1 << b))
+                r |= (uint8_t)(0x80 >> b);
+        reverse8[i] = r;
+    }
+}
+
+static int popcount64(uint64_t v) {
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((v * 0x0101010101010101ULL) >> 56);
+}
+
+// Number of live cells in [lo, hi) of a bit-packed row.
+static int count_range(const uint64_t *row, int lo, int hi) {
+    int count = 0;
+    while (lo < hi) {
+        int      bit  = lo & 63;
+        int      take = (hi - lo < 64 - bit) ? hi - lo : 64 - bit;
+        uint64_t bits = row[lo >> 6] >> bit;
+        if (take < 64)
+            bits &= (1ULL << take) - 1;
+        count += popcount64(bits);
+        lo += take;
+    }
+    return count;
+}
+
+// Popcount of each `bits`-wide field of v, for bits a power of two <= 64,
+// left in place in that field.
+static uint64_t field_counts(uint64_t v, int bits) {
+    if (bits >= 2)
+        v = (v & 0x5555555555555555ULL) + ((v >> 1) & 0x5555555555555555ULL);
+    if (bits >= 4)
+        v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    if (bits >= 8)
+        v = (v & 0x0F0F0F0F0F0F0F0FULL) + ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL);
+    if (bits >= 16)
+        v = (v & 0x00FF00FF00FF00FFULL) + ((v >> 8) & 0x00FF00FF00FF00FFULL);
+    if (bits >= 32)
+        v = (v & 0x0000FFFF0000FFFFULL) + ((v >> 16) & 0x0000FFFF0000FFFFULL);
+    if (bits >= 64)
+        v = (v & 0x00000000FFFFFFFFULL) + (v >> 32);
+    return v;
+}
+
+// Add the live-cell count of each `scale`-wide column block of row to live[].
+static void accumulate(int *live, const uint64_t *row, const export_opts *o) {
+    int cols = (o->width + o->scale - 1) / o->scale;
+
+    if (o->scale <= 64 && (o->scale & (o->scale - 1)) == 0) {
+        // Power-of-two blocks never straddle a word: count them all at once.
+        int      per  = 64 / o->scale;
+        uint64_t mask = (o->scale == 64) ? ~0ULL : (1ULL << o->scale) - 1;
+        for (int x = 0, w = 0; x < cols; w++) {
+            uint64_t v = field_counts(row[w], o->scale);
+            for (int j = 0; j < per && x < cols; j++, x++)
+                live[x] += (int)((v >> (j * o->scale)) & mask);
+        }
+        return;
+    }
+
+    for (int x = 0; x < cols; x++) {
+        int hi = (x + 1) * o->scale;
+        live[x] += count_range(row, x * o->scale, hi < o->width ? hi : o->width);
+    }
+}
+
+static int is_tap(const export_opts *o, int lo, int hi) {
+    for (int i = 0; i < 3; i++)
+        if (o->taps[i] >= lo && o->taps[i] < hi)
+            return 1;
+    return 0;
+}
+
+// PBM scanline: cell i is pixel i, 1 = black, MSB first within each byte.
+// Rows store cell i at bit i % 64 of word i / 64, so each byte of a word
+// maps to one output byte with its bits reversed.
+static void pbm_scanline(uint8_t *out, const uint64_t *row, int width) {
+    int nbytes = (width + 7) / 8;
+    for (int i = 0; i < nbytes; i++)
+        out[i] = reverse8[(row[i >> 3] >> (8 * (i & 7))) & 0xFF];
+}
+
+static FILE *open_image(const export_opts *o, uint64_t index, uint64_t rows) {
+    char        name[4096];
+    const char *path = o->path;
+
+    if (o->tile) {
+        const char *dot  = strrchr(o->path, '.');
+        int         stem = dot ? (int)(dot - o->path) : (int)strlen(o->path);
+        snprintf(name, sizeof(name), "%.*s_%05llu%s", stem, o->path, (unsigned long long)index, dot ? dot : "");
+        path = name;
+    }
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return NULL;
+    }
+    setvbuf(f, NULL, _IOFBF, 1 << 20);
+
+    if (o->format == FMT_PBM) {
+        fprintf(f, "P4\n%d %llu\n", o->width, (unsigned long long)(rows + (o->mark ? RULER_ROWS : 0)));
+        if (o->mark) {
+            uint8_t ruler[PRNG30_MAX_WIDTH / 8];
+            memset(ruler, 0, sizeof(ruler));
+            for (int i = 0; i < 3; i++)
+                ruler[o->taps[i] / 8] |= (uint8_t)(0x80 >> (o->taps[i] % 8));
+            for (int r = 0; r < RULER_ROWS; r++)
+                fwrite(ruler, 1, (size_t)(o->width + 7) / 8, f);
+        }
+    } else {
+        int cols = (o->width + o->scale - 1) / o->scale;
+        int h    = (int)((rows + (uint64_t)o->scale - 1) / (uint64_t)o->scale);
+        fprintf(f, "P5\n%d %d\n255\n", cols, h + (o->mark ? RULER_ROWS : 0));
+        if (o->mark) {
+            uint8_t ruler[PRNG30_MAX_WIDTH];
+            for (int x = 0; x < cols; x++)
+                ruler[x] = is_tap(o, x * o->scale, (x + 1) * o->scale) ? 0 : 255;
+            for (int r = 0; r < RULER_ROWS; r++)
+                fwrite(ruler, 1, (size_t)cols, f);
+        }
+    }
+
+    return f;
+}
+
+static int close_image(FILE *f) {
+    int bad = ferror(f);
+    if (fclose(f) != 0)
+        bad = 1;
+    if (bad)
+        fprintf(stderr, "write error\n");
+    return bad ? -1 : 0;
+}
+
+static int export_pbm(const export_opts *o, prng30_state *st, uint64_t gens) {
+    uint8_t  line[PRNG30_MAX_WIDTH / 8];
+    size_t   nbytes = (size_t)(o->width + 7) / 8;
+    uint64_t per    = o->tile ? o->tile : gens;
+
+    for (uint64_t done = 0, index = 0; done < gens; index++) {
+        uint64_t rows = (gens - done < per) ? gens - done : per;
+        FILE    *f    = open_image(o, index, rows);
+        if (!f)
+            return -1;
+        for (uint64_t r = 0; r < rows; r++) {
+            prng30_step(st);
+            pbm_scanline(line, st->row, o->width);
+            fwrite(line, 1, nbytes, f);
+        }
+        if (close_image(f) != 0)
+            return -1;
+        done += rows;
+    }
+    return 0;
+}
+
+static int export_pgm(const export_opts *o, prng30_state *st, uint64_t gens) {
+    int      cols = (o->width + o->scale - 1) / o->scale;
+    int     *live = calloc((size_t)cols, sizeof(int));
+    uint8_t *line = malloc((size_t)cols);
+    // Tiles hold whole pixel rows so tile seams do not split a block.
+    uint64_t per = o->tile ? (o->tile + (uint64_t)o->scale - 1) / (uint64_t)o->scale * (uint64_t)o->scale : gens;
+    int      ret = 0;
+
+    if (!live || !line) {
+        fprintf(stderr, "out of memory\n");
+        free(live);
+        free(line);
+        return -1;
+    }
+
+    for (uint64_t done = 0, index = 0; done < gens && ret == 0; index++) {
+        uint64_t rows = (gens - done < per) ? gens - done : per;
+        FILE    *f    = open_image(o, index, rows);
+        if (!f) {
+            ret = -1;
+            break;
+        }
+        for (uint64_t r = 0; r < rows; r++) {
+            prng30_step(st);
+            accumulate(live, st->row, o);
+            // Emit a pixel row after every `scale` generations, or at the
+            // end of the tile for a partial block. Blocks cut short at the
+            // right edge or the tile end are averaged over the cells they
+            // actually cover.
+            if ((r + 1) % (uint64_t)o->scale == 0 || r + 1 == rows) {
+                int h = (int)(r % (uint64_t)o->scale) + 1;
+                for (int x = 0; x < cols; x++) {
+                    int w   = o->width - x * o->scale;
+                    int n   = h * (w < o->scale ? w : o->scale);
+                    line[x] = (uint8_t)(255 - live[x] * 255 / n);
+                    live[x] = 0;
+                }
+                fwrite(line, 1, (size_t)cols, f);
+            }
+        }
+        ret = close_image(f);
+        done += rows;
+    }
+
+    free(live);
+    free(line);
+    return ret;
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: prng30_export [--scale N] [--tile N] [--mark] <output> [seed] [width] [generations]\n");
+}
+
+int main(int argc, char *argv[]) {
+    export_opts o;
+    uint64_t    seed = (uint64_t)time(NULL);
+    uint64_t    gens = 1000;
+    const char *pos[4];
+    int         npos = 0;
+
+    memset(&o, 0, sizeof(o));
+    o.scale = 4;
+    o.width = 64;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+            o.scale = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tile") == 0 && i + 1 < argc)
+            o.tile = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--mark") == 0)
+            o.mark = 1;
+        else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            usage();
+            return 1;
+        } else if (npos < 4)
+            pos[npos++] = argv[i];
+    }
+
+    if (npos < 1) {
+        usage();
+        return 1;
+    }
+    o.path = pos[0];
+    if (npos >= 2)
+        seed = (uint64_t)strtoull(pos[1], NULL, 0);
+    if (npos >= 3)
+        o.width = (int)strtol(pos[2], NULL, 10);
+    if (npos >= 4)
+        gens = strtoull(pos[3], NULL, 10);
+
+    const char *dot = strrchr(o.path, '.');
+    o.format        = (dot && strcmp(dot, ".pgm") == 0) ? FMT_PGM : FMT_PBM;
+
+    if (o.width < PRNG30_MIN_WIDTH || o.width > PRNG30_MAX_WIDTH) {
+        fprintf(stderr, "width must be in [%d, %d]\n", PRNG30_MIN_WIDTH, PRNG30_MAX_WIDTH);
+        return 1;
+    }
+    if (o.scale < 1 || o.scale > 256) {
+        fprintf(stderr, "scale must be in [1, 256]\n");
+        return 1;
+    }
+
+    // Same tap columns as prng30_generate.
+    int mid   = o.width / 2;
+    int tap   = o.width / 8;
+    o.taps[0] = (mid - tap + o.width) % o.width;
+    o.taps[1] = mid;
+    o.taps[2] = (mid + tap) % o.width;
+
+    prng30_state st;
+    prng30_err   err = prng30_init(&st, seed, o.width);
+    if (err != PRNG30_OK) {
+        fprintf(stderr, "prng30_init failed: %d\n", err);
+        return 1;
+    }
+
+    init_reverse8();
+
+    clock_t t0  = clock();
+    int     ret = (o.format == FMT_PBM) ? export_pbm(&o, &st, gens) : export_pgm(&o, &st, gens);
+    double  sec = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    prng30_free(&st);
+
+    if (ret != 0)
+        return 1;
+    fprintf(stderr, "exported %llu generations of width %d in %.2f s\n", (unsigned long long)gens, o.width, sec);
+    return 0;
+}
@@ -11,63 +11,290 @@
 static void ms_sleep(int ms) {
     Sleep(ms);
 }
-static void clear_screen(void) {
-    system("cls");
+static void term_size(int *cols, int *rows) {
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    HANDLE                     out = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD                      mode;
+    *cols = 80;
+    *rows = 25;
+    if (GetConsoleScreenBufferInfo(out, &info)) {
+        *cols = info.srWindow.Right - info.srWindow.Left + 1;
+        *rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+    }
+    if (GetConsoleMode(out, &mode))
+        SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    SetConsoleOutputCP(CP_UTF8);
+}
+static void write_all(const char *buf, size_t len) {
+    fwrite(buf, 1, len, stdout);
+    fflush(stdout);
 }
 #else
+#include <sys/ioctl.h>
 #include <unistd.h>
 static void ms_sleep(int ms) {
     usleep((unsigned int)(ms * 1000));
 }
-static void clear_screen(void) {
-    system("clear");
+static void term_size(int *cols, int *rows) {
+    struct winsize ws;
+    *cols = 80;
+    *rows = 24;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0) {
+        *cols = ws.ws_col;
+        *rows = ws.ws_row;
+    }
+}
+// Frames bypass stdio; flush it first so earlier printf output (the seed
+// line) stays ahead of them when stdout is a pipe or file.
+static void write_all(const char *buf, size_t len) {
+    fflush(stdout);
+    while (len > 0) {
+        ssize_t n = write(STDOUT_FILENO, buf, len);
+        if (n <= 0)
+            return;
+        buf += n;
+        len -= (size_t)n;
+    }
 }
 #endif
 
 #define COL_RED "\033[31m"
 #define COL_BLUE "\033[34m"
-#define COL_GRAY "\033[90m"
 #define COL_RESET "\033[0m"
 
 #define MAX_DISPLAY_ROWS 40
 
+// Rows of text above and below the automaton.
+#define HEADER_LINES 2
+#define FOOTER_LINES 2
+
+//  Each character cell shows a 2x2 block of sub-pixels: two generations
+//  tall and two column groups wide. Mask bits: 1 = upper left,
+//  2 = upper right, 4 = lower left, 8 = lower right.
+static const char *const quadrant[16] = {
+    " ", "▘", "▝", "▀", "▖", "▌", "▞", "▛",
+    "▗", "▚", "▐", "▜", "▄", "▙", "▟", "█",
+};
+
+// Frame cell flag: draw in the extraction column colour.
+#define CELL_MID 0x10
+
+typedef struct {
+    char  *data;
+    size_t len;
+} frame_buf;
+
+static void put(frame_buf *fb, const char *s) {
+    size_t n = strlen(s);
+    memcpy(fb->data + fb->len, s, n);
+    fb->len += n;
+}
+
+static int popcount64(uint64_t v) {
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((v * 0x0101010101010101ULL) >> 56);
+}
+
+// Number of live cells in [lo, hi) of a bit-packed row.
+static int count_range(const uint64_t *row, int lo, int hi) {
+    int count = 0;
+    while (lo < hi) {
+        int      bit  = lo & 63;
+        int      take = (hi - lo < 64 - bit) ? hi - lo : 64 - bit;
+        uint64_t bits = row[lo >> 6] >> bit;
+        if (take < 64)
+            bits &= (1ULL << take) - 1;
+        count += popcount64(bits);
+        lo += take;
+    }
+    return count;
+}
+
+typedef struct {
+    int       width;
+    int       nwords;
+    int       group;  // automaton cells per sub-pixel column
+    int       halves; // 1: one group per character, 2: two groups
+    int       nchars; // character columns
+    int       nlines; // character rows, two generations each
+    int       gens;   // generations shown, 2 * nlines
+    int       mid_char;
+    uint64_t *ring; // last `gens` rows, bit-packed
+    int       head; // ring slot of the newest row
+    int       filled;
+    uint8_t  *prev; // glyph + flags currently on screen
+    uint8_t  *cur;
+    frame_buf fb;
+} renderer;
+
+static int renderer_init(renderer *r, int width, int cols, int rows) {
+    memset(r, 0, sizeof(*r));
+    r->width  = width;
+    r->nwords = PRNG30_WORDS(width);
+
+    if (cols < 8)
+        cols = 8;
+
+    // Fit to the terminal: one cell per character (half blocks) if the
+    // automaton is narrow enough, otherwise two column groups per
+    // character (quarter blocks), each summarising `group` cells.
+    if (width <= cols) {
+        r->group  = 1;
+        r->halves = 1;
+        r->nchars = width;
+    } else {
+        r->group  = (width + 2 * cols - 1) / (2 * cols);
+        r->halves = 2;
+        r->nchars = ((width + r->group - 1) / r->group + 1) / 2;
+    }
+    r->mid_char = (width / 2) / (r->group * r->halves);
+
+    r->nlines = rows - HEADER_LINES - FOOTER_LINES;
+    if (r->nlines > MAX_DISPLAY_ROWS / 2)
+        r->nlines = MAX_DISPLAY_ROWS / 2;
+    if (r->nlines < 1)
+        r->nlines = 1;
+    r->gens = 2 * r->nlines;
+
+    size_t cells = (size_t)r->nlines * (size_t)r->nchars;
+    r->ring      = calloc((size_t)r->gens * (size_t)r->nwords, sizeof(uint64_t));
+    r->prev      = calloc(cells, 1);
+    r->cur       = calloc(cells, 1);
+    // Worst case per cell: cursor move, colour change and a 3-byte glyph.
+    r->fb.data = malloc(cells * 32 + 256);
+    r->head    = -1;
+
+    return r->ring && r->prev && r->cur && r->fb.data;
+}
+
+static void renderer_free(renderer *r) {
+    free(r->ring);
+    free(r->prev);
+    free(r->cur);
+    free(r->fb.data);
+}
+
+static void renderer_push(renderer *r, const prng30_state *st) {
+    r->head = (r->head + 1) % r->gens;
+    memcpy(r->ring + (size_t)r->head * (size_t)r->nwords, st->row, (size_t)r->nwords * sizeof(uint64_t));
+    if (r->filled < r->gens)
+        r->filled++;
+}
+
+// Sub-pixel value of column group `g` in a row: on if at least half of its
+// cells are live.
+static int subpixel(const renderer *r, const uint64_t *row, int g) {
+    int lo = g * r->group;
+    int hi = lo + r->group;
+    if (lo >= r->width)
+        return 0;
+    if (hi > r->width)
+        hi = r->width;
+    return 2 * count_range(row, lo, hi) >= hi - lo;
+}
+
+static void compose(renderer *r) {
+    // Generation k of the display (0 = oldest) lives in ring slot
+    // head - filled + 1 + k; rows that have not been generated yet are blank.
+    int oldest = r->head - r->filled + 1 + r->gens;
+
+    for (int line = 0; line < r->nlines; line++) {
+        const uint64_t *rows[2];
+        for (int h = 0; h < 2; h++) {
+            int k   = 2 * line + h;
+            rows[h] = (k < r->filled) ? r->ring + (size_t)((oldest + k) % r->gens) * (size_t)r->nwords : NULL;
+        }
+
+        uint8_t *out = r->cur + (size_t)line * (size_t)r->nchars;
+        for (int c = 0; c < r->nchars; c++) {
+            uint8_t mask = 0;
+            for (int h = 0; h < 2; h++) {
+                if (!rows[h])
+                    continue;
+                int left  = subpixel(r, rows[h], c * r->halves);
+                int right = (r->halves == 2) ? subpixel(r, rows[h], c * 2 + 1) : left;
+                mask |= (uint8_t)((left | (right << 1)) << (2 * h));
+            }
+            out[c] = mask | (c == r->mid_char ? CELL_MID : 0);
+        }
+    }
+}
+
+// Emit only the characters that differ from what is on screen.
+static void emit_diff(renderer *r) {
+    char esc[32];
+    int  colour = -1;
+
+    for (int line = 0; line < r->nlines; line++) {
+        int cursor = -1; // column the terminal cursor is at, if on this line
+        for (int c = 0; c < r->nchars; c++) {
+            size_t  i = (size_t)line * (size_t)r->nchars + (size_t)c;
+            uint8_t v = r->cur[i];
+            if (v == r->prev[i])
+                continue;
+            if (cursor != c) {
+                snprintf(esc, sizeof(esc), "\033[%d;%dH", HEADER_LINES + line + 1, c + 1);
+                put(&r->fb, esc);
+            }
+            int want = (v & CELL_MID) ? 1 : 0;
+            if (want != colour) {
+                put(&r->fb, want ? COL_RED : COL_BLUE);
+                colour = want;
+            }
+            put(&r->fb, quadrant[v & 15]);
+            r->prev[i] = v;
+            cursor     = c + 1;
+        }
+    }
+
+    if (colour != -1)
+        put(&r->fb, COL_RESET);
+}
+
+static void render(renderer *r, int step, int steps) {
+    char header[128];
+
+    r->fb.len = 0;
+    snprintf(header, sizeof(header), "\033[HRule 30  width=%d  step %d/%d\033[K", r->width, step, steps);
+    put(&r->fb, header);
+
+    compose(r);
+    emit_diff(r);
+
+    write_all(r->fb.data, r->fb.len);
+}
+
 static void visualize(prng30_state *st, int steps, int delay_ms) {
-    int width = st->width;
-    int mid   = width / 2;
+    int      cols, rows;
+    renderer r;
+    char     buf[256];
 
-    uint8_t *history = calloc((size_t)(steps * width), sizeof(uint8_t));
-    if (!history) {
+    term_size(&cols, &rows);
+    if (!renderer_init(&r, st->width, cols, rows)) {
         fprintf(stderr, "visualizer: out of memory\n");
+        renderer_free(&r);
         return;
     }
 
+    // Clear once and hide the cursor; every later frame is drawn in place.
+    int n = snprintf(buf, sizeof(buf), "\033[2J\033[?25l\033[%d;1H" COL_RED "red" COL_RESET " = extraction column",
+                     HEADER_LINES + r.nlines + 2);
+    if (r.group * r.halves > 1)
+        n += snprintf(buf + n, sizeof(buf) - (size_t)n, "  (%d cells per character)", r.group * r.halves);
+    write_all(buf, (size_t)n);
+
     for (int g = 0; g < steps; g++) {
         prng30_step(st);
-        memcpy(history + g * width, st->row, (size_t)width);
-
-        clear_screen();
-        printf("Rule 30  width=%d  step %d/%d\n\n", width, g + 1, steps);
-
-        int first = (g < MAX_DISPLAY_ROWS) ? 0 : (g + 1 - MAX_DISPLAY_ROWS);
-        for (int row = first; row <= g; row++) {
-            uint8_t *r = history + row * width;
-            for (int col = 0; col < width; col++) {
-                uint8_t bit = r[col];
-                if (col == mid)
-                    printf(COL_RED "%c " COL_RESET, bit ? '#' : '.');
-                else if (bit)
-                    printf(COL_BLUE "#" COL_RESET " ");
-                else
-                    printf(COL_GRAY "." COL_RESET " ");
-            }
-            printf("\n");
-        }
-
-        printf("\n" COL_RED "# = extraction column" COL_RESET "\n");
+        renderer_push(&r, st);
+        render(&r, g + 1, steps);
         ms_sleep(delay_ms);
     }
 
-    free(history);
+    n = snprintf(buf, sizeof(buf), "\033[%d;1H\033[?25h", HEADER_LINES + r.nlines + FOOTER_LINES + 1);
+    write_all(buf, (size_t)n);
+    renderer_free(&r);
 
     uint64_t result = prng30_generate(st, 64);
     printf("\ngenerated: %llu (0x%016llX)\n", (unsigned long long)result, (unsigned long long)result);
@@ -104,4 +331,4 @@ int main(int argc, char *argv[]) {
 
     prng30_free(&st);
     return 0;
-}
\ No newline at end of file
+}